@@ -52,12 +52,12 @@ void EosChanBlock::onValueChanged() {
     if (!qFuzzyCompare(1 + hsv.h, 1 + m_lastValue.h) || !qFuzzyCompare(1 + hsv.s, 1 + m_lastValue.s)) {
         QString message = "/eos/user/0/chan/%1/param/hue/saturation";
         message = message.arg(QString::number(m_chanNumber));
-        m_controller->lightingConsole()->sendMessage(message, hsv.h * 360, hsv.s * 100);
+        m_controller->lightingConsole()->sendCoalescedMessage(message, hsv.h * 360, hsv.s * 100);
     }
     if (hsv.v != m_lastValue.v) {
         QString message = "/eos/user/0/chan/%1";
         message = message.arg(QString::number(m_chanNumber));
-        m_controller->lightingConsole()->sendMessage(message, hsv.v * 100);
+        m_controller->lightingConsole()->sendCoalescedMessage(message, hsv.v * 100);
     }
     m_lastValue = hsv;
     emit lastValueChanged();
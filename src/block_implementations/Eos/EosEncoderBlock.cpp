@@ -111,10 +111,8 @@ void EosEncoderBlock::onIncomingEosMessage(const EosOSCMessage& msg) {
 }
 
 void EosEncoderBlock::onFeedbackEnabledChanged() {
+    EosMessageRouter* router = m_controller->eosManager()->router();
+    router->removeRoutes(this);
     if (m_feedbackEnabled)
-        connect(m_controller->eosManager(), SIGNAL(eosMessageReceived(EosOSCMessage)),
-                this, SLOT(onIncomingEosMessage(EosOSCMessage)));
-    else
-        disconnect(m_controller->eosManager(), SIGNAL(eosMessageReceived(EosOSCMessage)),
-                this, SLOT(onIncomingEosMessage(EosOSCMessage)));
+        router->addRoute("active/wheel/*", this, [this](const EosOSCMessage& msg) { onIncomingEosMessage(msg); });
 }
@@ -22,8 +22,9 @@ EosFaderBankBlock::EosFaderBankBlock(MainController* controller, QString uid)
 {
     connect(m_controller->eosManager(), SIGNAL(connectionEstablished()),
             this, SLOT(onEosConnectionEstablished()));
-    connect(controller->eosManager(), SIGNAL(eosMessageReceived(EosOSCMessage)),
-            this, SLOT(onIncomingEosMessage(EosOSCMessage)));
+    // only messages of this fader bank are passed to onIncomingEosMessage():
+    controller->eosManager()->router()->addRoute("fader/" + m_bankIndex + "/...", this,
+                                                 [this](const EosOSCMessage& msg) { onIncomingEosMessage(msg); });
     connect(controller->eosManager(), SIGNAL(connectionReset()),
             this, SLOT(onConnectionReset()));
     connect(&m_numFaders, &IntegerAttribute::valueChanged, this, &EosFaderBankBlock::updateFaderCount);
@@ -69,7 +70,7 @@ void EosFaderBankBlock::setFaderLevel(int faderIndex, qreal value) {
 
     QString message = "/eos/user/1/fader/%1/%2";
     message = message.arg(m_bankIndex, QString::number(faderIndex + 1));
-    m_controller->lightingConsole()->sendMessage(message, value);
+    m_controller->lightingConsole()->sendCoalescedMessage(message, value);
 }
 
 void EosFaderBankBlock::setFaderLevelFromGui(int faderIndex, qreal value) {
@@ -26,8 +26,9 @@ EosSingleFaderBlock::EosSingleFaderBlock(MainController* controller, QString uid
 
     connect(m_controller->eosManager(), SIGNAL(connectionEstablished()),
             this, SLOT(onEosConnectionEstablished()));
-    connect(controller->eosManager(), SIGNAL(eosMessageReceived(EosOSCMessage)),
-            this, SLOT(onIncomingEosMessage(EosOSCMessage)));
+    // only messages of this fader bank are passed to onIncomingEosMessage():
+    controller->eosManager()->router()->addRoute("fader/" + m_bankIndex + "/...", this,
+                                                 [this](const EosOSCMessage& msg) { onIncomingEosMessage(msg); });
     connect(controller->eosManager(), SIGNAL(connectionReset()),
             this, SLOT(onConnectionReset()));
 
@@ -104,7 +105,7 @@ void EosSingleFaderBlock::setFaderLevelFromGui(qreal value) {
 
     QString message = "/eos/user/1/fader/%1/%2";
     message = message.arg(m_bankIndex, QString::number(m_faderNumber));
-    m_controller->lightingConsole()->sendMessage(message, value);
+    m_controller->lightingConsole()->sendCoalescedMessage(message, value);
 }
 
 void EosSingleFaderBlock::setFaderLevelFromOsc(int faderIndex, qreal value){
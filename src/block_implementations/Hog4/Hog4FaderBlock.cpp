@@ -54,7 +54,19 @@ Hog4FaderBlock::Hog4FaderBlock(MainController* controller, QString uid)
     connect(&m_flashButton, &BoolAttribute::valueChanged, this, &Hog4FaderBlock::sendFlashButton);
     connect(&m_faderValue, &DoubleAttribute::valueChanged, this, &Hog4FaderBlock::sendFaderValue);
 
-    connect(controller->lightingConsole(), SIGNAL(messageReceived(OSCMessage)), this, SLOT(onMessageReceived(OSCMessage)));
+    connect(&m_masterNumber, &IntegerAttribute::valueChanged, this, &Hog4FaderBlock::updateRoutes);
+    updateRoutes();
+}
+
+void Hog4FaderBlock::updateRoutes() {
+    // only messages of this master are passed to onMessageReceived():
+    OSCRouter* router = m_controller->lightingConsole()->router();
+    router->removeRoutes(this);
+    const QString number = QString::number(m_masterNumber);
+    auto handler = [this](const OSCMessage& msg) { onMessageReceived(msg); };
+    router->addRoute("/hog/status/led/choose/" + number, this, handler);
+    router->addRoute("/hog/status/led/flash/" + number, this, handler);
+    router->addRoute("/hog/hardware/fader/" + number, this, handler);
 }
 
 void Hog4FaderBlock::onMessageReceived(OSCMessage msg) {
@@ -107,6 +119,6 @@ void Hog4FaderBlock::sendFaderValue() {
     if (faderValue == m_lastSentFaderValue) return;
     QString message = "/hog/hardware/fader/%1";
     message = message.arg(QString::number(m_masterNumber));
-    m_controller->lightingConsole()->sendMessage(message, double(faderValue));
+    m_controller->lightingConsole()->sendCoalescedMessage(message, double(faderValue));
     m_lastSentFaderValue = faderValue;
 }
@@ -34,6 +34,7 @@ public slots:
     virtual BlockInfo getBlockInfo() const override { return info(); }
 
 protected slots:
+    void updateRoutes();
     void onMessageReceived(OSCMessage msg);
 
     void sendChooseButton();
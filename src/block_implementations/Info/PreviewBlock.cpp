@@ -20,6 +20,7 @@ QVector<double> PreviewBlock::getValueHistory() const {
 }
 
 void PreviewBlock::eachFrame() {
+    ProfilerScope profilerScope(this, FrameProfiler::BlockUpdate);
     double value = m_inputNode->getValue();
     m_currentValue = value;
     if (m_inputNode->constData().absoluteMaximumIsProvided()) {
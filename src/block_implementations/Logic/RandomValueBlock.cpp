@@ -62,6 +62,7 @@ void RandomValueBlock::fillRandom(HsvMatrix& matrix) const {
 }
 
 void RandomValueBlock::eachFrame(double timeSinceLastFrame) {
+    ProfilerScope profilerScope(this, FrameProfiler::BlockUpdate);
     // advance position value:
     double stepTime = m_currentStepTime;
     if (m_inputNode->isConnected() && !m_inputNode->constData().absoluteMaximumIsProvided()) {
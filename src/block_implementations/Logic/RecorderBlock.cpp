@@ -107,6 +107,7 @@ double RecorderBlock::getBpm() const {
 }
 
 void RecorderBlock::eachFrame() {
+    ProfilerScope profilerScope(this, FrameProfiler::BlockUpdate);
     if (m_playing && !m_data.isEmpty()) {
         // playing
         double value = m_data[m_playbackPosition % m_data.size()];
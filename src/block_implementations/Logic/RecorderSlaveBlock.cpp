@@ -61,6 +61,7 @@ void RecorderSlaveBlock::toggleOverdub() {
 }
 
 void RecorderSlaveBlock::eachFrame() {
+    ProfilerScope profilerScope(this, FrameProfiler::BlockUpdate);
     if (m_recording) {
         // recording
         if (m_linkNode->getValue() < LuminosusConstants::triggerThreshold) {
@@ -68,6 +68,7 @@ void SequencerBlock::sync() {
 }
 
 void SequencerBlock::eachFrame(double timeSinceLastFrame) {
+    ProfilerScope profilerScope(this, FrameProfiler::BlockUpdate);
     if (m_time <= 0) return;
     if (m_dynamicNodes.size() < 2) return;
     double progress = timeSinceLastFrame / m_time;
@@ -32,6 +32,7 @@ void SinusValueBlock::sync() {
 }
 
 void SinusValueBlock::eachFrame(double timeSinceLastFrame) {
+    ProfilerScope profilerScope(this, FrameProfiler::BlockUpdate);
     // advance position value:
     double stepTime = m_stepTime;
     if (m_inputNode->isConnected() && !m_inputNode->constData().absoluteMaximumIsProvided()) {
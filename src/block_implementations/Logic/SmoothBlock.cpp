@@ -17,6 +17,7 @@ SmoothBlock::SmoothBlock(MainController* controller, QString uid)
 }
 
 void SmoothBlock::eachFrame() {
+    ProfilerScope profilerScope(this, FrameProfiler::BlockUpdate);
     auto input = m_inputNode->constData();
     HsvDataModifier out(m_outputNode);
     const double minResolution = 1.0 / (256 * 256);
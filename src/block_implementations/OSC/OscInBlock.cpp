@@ -29,13 +29,11 @@ OscInBlock::OscInBlock(MainController *controller, QString uid)
 	, m_message("")
 	, m_minValue(0)
 	, m_maxValue(1)
+	, m_routedConnection(nullptr)
 {
     connect(m_controller, SIGNAL(sendCustomOscToEosChanged()), this, SLOT(updateConnection()));
-    if (m_controller->getSendCustomOscToEos()) {
-        connect(controller->lightingConsole(), SIGNAL(messageReceived(OSCMessage)), this, SLOT(onMessageReceived(OSCMessage)));
-    } else {
-        connect(controller->customOsc(), SIGNAL(messageReceived(OSCMessage)), this, SLOT(onMessageReceived(OSCMessage)));
-    }
+    connect(this, SIGNAL(messageChanged()), this, SLOT(updateConnection()));
+    updateConnection();
 }
 
 void OscInBlock::getAdditionalState(QJsonObject& state) const {
@@ -51,16 +49,15 @@ void OscInBlock::setAdditionalState(const QJsonObject &state) {
 }
 
 void OscInBlock::onMessageReceived(OSCMessage msg) {
-	if (msg.pathString() == m_message) {
-		emit validMessageReceived();
-		if (msg.arguments().size() == 0) {
-			m_outputNode->setValue(1.0);
-			QTimer::singleShot(100, this, SLOT(onEndOfPulse()));
-		} else {
-			double value = (msg.value() - m_minValue) / (m_maxValue - m_minValue);
-			value = limit(0, value, 1);
-			m_outputNode->setValue(value);
-		}
+	// only called by the router for matching messages
+	emit validMessageReceived();
+	if (msg.arguments().size() == 0) {
+		m_outputNode->setValue(1.0);
+		QTimer::singleShot(100, this, SLOT(onEndOfPulse()));
+	} else {
+		double value = (msg.value() - m_minValue) / (m_maxValue - m_minValue);
+		value = limit(0, value, 1);
+		m_outputNode->setValue(value);
 	}
 }
 
@@ -69,13 +66,13 @@ void OscInBlock::onEndOfPulse() {
 }
 
 void OscInBlock::updateConnection() {
-    if (m_controller->getSendCustomOscToEos()) {
-        disconnect(m_controller->customOsc(), SIGNAL(messageReceived(OSCMessage)), this, SLOT(onMessageReceived(OSCMessage)));
-        connect(m_controller->lightingConsole(), SIGNAL(messageReceived(OSCMessage)), this, SLOT(onMessageReceived(OSCMessage)));
-    } else {
-        disconnect(m_controller->lightingConsole(), SIGNAL(messageReceived(OSCMessage)), this, SLOT(onMessageReceived(OSCMessage)));
-        connect(m_controller->customOsc(), SIGNAL(messageReceived(OSCMessage)), this, SLOT(onMessageReceived(OSCMessage)));
+    if (m_routedConnection) {
+        m_routedConnection->router()->removeRoutes(this);
     }
+    m_routedConnection = m_controller->getSendCustomOscToEos() ? m_controller->lightingConsole() : m_controller->customOsc();
+    if (m_message.isEmpty()) return;
+    // the message can also be an OSC address pattern with wildcards:
+    m_routedConnection->router()->addRoute(m_message, this, [this](const OSCMessage& msg) { onMessageReceived(msg); });
 }
 
 void OscInBlock::setMinValue(double value) {
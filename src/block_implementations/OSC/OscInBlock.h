@@ -24,6 +24,8 @@
 #include "core/block_data/OneOutputBlock.h"
 #include "osc/OSCMessage.h"
 
+class OSCNetworkManager;
+
 
 class OscInBlock : public OneOutputBlock
 {
@@ -42,6 +44,7 @@ public:
         info.category << "Custom OSC";
 		info.helpText = "Enter the path of an OSC message to listen for.\n\n"
 						"Outputs the value of the first parameter of any matching incoming message.\n"
+						"The path can contain OSC wildcards (i.e. '/fader/*').\n"
 						"The expected value range of the parameter can be specified above.\n\n"
 						"If the incoming message has no parameters a short pulse of on and off will be emitted "
                         "for each message received.\n\n"
@@ -86,6 +89,7 @@ protected:
 	QString m_message;
 	double m_minValue;
 	double m_maxValue;
+	OSCNetworkManager* m_routedConnection;  // the connection the route is registered at
 };
 
 #endif // OSCINBLOCK_H
@@ -282,6 +282,7 @@ QList<QObject*> CueListBlock::getCues() {
 }
 
 void CueListBlock::eachFrame(double timeSinceLastFrame) {
+    ProfilerScope profilerScope(this, FrameProfiler::BlockUpdate);
     // prerequirements:
     if (!m_running) return;
     Cue* activeCue = m_activeCue;
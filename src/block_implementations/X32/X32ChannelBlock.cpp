@@ -41,8 +41,17 @@ X32ChannelBlock::X32ChannelBlock(MainController* controller, QString uid)
     connect(m_inputNode, &NodeBase::dataChanged, [this](){ m_faderPos.setValue(m_inputNode->getValue()); });
     connect(m_panNode, &NodeBase::dataChanged, [this](){ m_pan.setValue(m_panNode->getValue()); });
 
-    connect(controller->audioConsole(), SIGNAL(messageReceived(OSCMessage)), this, SLOT(onMessageReceived(OSCMessage)));
+    connect(&m_channelNumber, SIGNAL(valueChanged()), this, SLOT(updateRoute()));
+    updateRoute();
+}
 
+void X32ChannelBlock::updateRoute() {
+    // only messages of this channel are passed to onMessageReceived():
+    OSCRouter* router = m_controller->audioConsole()->router();
+    router->removeRoutes(this);
+    QString channelPrefix = "/ch/%1";
+    channelPrefix = channelPrefix.arg(m_channelNumber, 2, 10, QChar('0'));
+    router->addPrefixRoute(channelPrefix, this, [this](const OSCMessage& msg) { onMessageReceived(msg); });
 }
 
 void X32ChannelBlock::setState(const QJsonObject& state) {
@@ -68,7 +77,7 @@ void X32ChannelBlock::sendFaderPos() {
 
     double value = m_boost ? m_faderPos : m_faderPos * 0.75;
 
-    m_controller->audioConsole()->sendMessage32bit(message, value);
+    m_controller->audioConsole()->sendCoalescedMessage32bit(message, value);
 }
 
 void X32ChannelBlock::sendName() {
@@ -83,7 +92,7 @@ void X32ChannelBlock::sendPan() {
     if (m_pauseValueTransmission) return;
     QString message = "/ch/%1/mix/pan";
     message = message.arg(m_channelNumber, 2, 10, QChar('0'));
-    m_controller->audioConsole()->sendMessage32bit(message, m_pan);
+    m_controller->audioConsole()->sendCoalescedMessage32bit(message, m_pan);
 }
 
 void X32ChannelBlock::sendOn() {
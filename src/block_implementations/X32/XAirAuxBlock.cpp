@@ -41,8 +41,8 @@ XAirAuxBlock::XAirAuxBlock(MainController* controller, QString uid)
     connect(m_inputNode, &NodeBase::dataChanged, [this](){ m_faderPos.setValue(m_inputNode->getValue()); });
     connect(m_panNode, &NodeBase::dataChanged, [this](){ m_pan.setValue(m_panNode->getValue()); });
 
-    connect(controller->audioConsole(), SIGNAL(messageReceived(OSCMessage)), this, SLOT(onMessageReceived(OSCMessage)));
-
+    // only messages of the aux return are passed to onMessageReceived():
+    controller->audioConsole()->router()->addPrefixRoute("/rtn/aux", this, [this](const OSCMessage& msg) { onMessageReceived(msg); });
 }
 
 void XAirAuxBlock::setState(const QJsonObject& state) {
@@ -65,7 +65,7 @@ void XAirAuxBlock::sendFaderPos() {
 
     double value = m_boost ? m_faderPos : m_faderPos * 0.75;
 
-    m_controller->audioConsole()->sendMessage32bit(message, value);
+    m_controller->audioConsole()->sendCoalescedMessage32bit(message, value);
 }
 
 void XAirAuxBlock::sendName() {
@@ -78,7 +78,7 @@ void XAirAuxBlock::sendName() {
 void XAirAuxBlock::sendPan() {
     if (m_pauseValueTransmission) return;
     QString message = "/rtn/aux/mix/pan";
-    m_controller->audioConsole()->sendMessage32bit(message, m_pan);
+    m_controller->audioConsole()->sendCoalescedMessage32bit(message, m_pan);
 }
 
 void XAirAuxBlock::sendOn() {
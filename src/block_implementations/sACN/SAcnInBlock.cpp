@@ -1,24 +1,27 @@
 #include "SAcnInBlock.h"
 
-#include "sacn/sacnlistener.h"
+#include "sacn/streamingacn.h"
+#include "sacn/sacnsubscription.h"
 #include "utils.h"
 
 
 SAcnInBlock::SAcnInBlock(MainController* controller, QString uid)
     : OneOutputBlock (controller, uid)
-    , m_listener(nullptr)
+    , m_subscription(nullptr)
     , m_universe(this, "universe", 1, 1, 63999)
     , m_channel(this, "channel", 1, 1, 512)
     , m_16bit(this, "16bit", false)
 {
     updateListener();
     connect(&m_universe, &IntegerAttribute::valueChanged, this, &SAcnInBlock::updateListener);
+    connect(&m_channel, &IntegerAttribute::valueChanged, this, &SAcnInBlock::updateListener);
 }
 
 void SAcnInBlock::onLevelsChanged() {
-    int level = m_listener->mergedLevels()[m_channel - 1].level;
+    // the subscription contains the coarse and the fine channel:
+    int level = m_subscription->level(0);
     if (m_16bit && m_channel < 512) {
-        int fine = m_listener->mergedLevels()[m_channel].level;
+        int fine = m_subscription->level(1);
         setValue(limit(0.0, (level + fine / 255.0) / 255.0, 1.0));
     } else {
         setValue(limit(0.0, level / 255.0, 1.0));
@@ -26,11 +29,12 @@ void SAcnInBlock::onLevelsChanged() {
 }
 
 void SAcnInBlock::updateListener() {
-    if (!m_listener.isNull()) {
-        disconnect(m_listener.data(), &sACNListener::levelsChanged, this, &SAcnInBlock::onLevelsChanged);
-        m_listener.clear();
+    if (m_subscription) {
+        delete m_subscription;
+        m_subscription = nullptr;
     }
-    m_listener = sACNManager::getInstance()->getListener(m_universe);
-    connect(m_listener.data(), &sACNListener::levelsChanged, this, &SAcnInBlock::onLevelsChanged);
+    // subscribe to the coarse and fine channel only:
+    m_subscription = sACNManager::getInstance()->subscribe(m_universe, m_channel - 1, 2, this);
+    connect(m_subscription, &sACNRangeSubscription::levelsChanged, this, &SAcnInBlock::onLevelsChanged);
     onLevelsChanged();
 }
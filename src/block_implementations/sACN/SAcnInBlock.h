@@ -4,7 +4,7 @@
 #include "core/block_data/OneOutputBlock.h"
 #include "core/SmartAttribute.h"
 
-class sACNListener;
+class sACNRangeSubscription;
 
 
 class SAcnInBlock : public OneOutputBlock {
@@ -40,7 +40,8 @@ private slots:
     void updateListener();
 
 protected:
-    QSharedPointer<sACNListener> m_listener;
+    // only receives the channels of this block, child of this block
+    sACNRangeSubscription* m_subscription;
 
     IntegerAttribute m_universe;
     IntegerAttribute m_channel;
@@ -1,13 +1,14 @@
 #include "VirtualFixtureBlock.h"
 
 #include "core/Nodes.h"
-#include "sacn/sacnlistener.h"
+#include "sacn/streamingacn.h"
+#include "sacn/sacnsubscription.h"
 #include "utils.h"
 
 
 VirtualFixtureBlock::VirtualFixtureBlock(MainController* controller, QString uid)
     : OneOutputBlock (controller, uid)
-    , m_listener(nullptr)
+    , m_subscription(nullptr)
     , m_universe(this, "universe", 1, 1, 63999)
     , m_channel(this, "channel", 1, 1, 512)
     , m_numChannels(this, "numChannels", 1, 1, 50)
@@ -15,7 +16,9 @@ VirtualFixtureBlock::VirtualFixtureBlock(MainController* controller, QString uid
 {
     updateListener();
     connect(&m_universe, &IntegerAttribute::valueChanged, this, &VirtualFixtureBlock::updateListener);
+    connect(&m_channel, &IntegerAttribute::valueChanged, this, &VirtualFixtureBlock::updateListener);
     connect(&m_numChannels, &IntegerAttribute::valueChanged, this, &VirtualFixtureBlock::updateNodeCount);
+    connect(&m_numChannels, &IntegerAttribute::valueChanged, this, &VirtualFixtureBlock::updateListener);
 }
 
 NodeBase* VirtualFixtureBlock::getChannelNode(int index) {
@@ -24,24 +27,25 @@ NodeBase* VirtualFixtureBlock::getChannelNode(int index) {
 }
 
 void VirtualFixtureBlock::onLevelsChanged() {
-    int level = m_listener->mergedLevels()[m_channel - 1].level;
-    setValue(limit(0.0, level / 255.0, 1.0));
-
-    for (int i=1; i<m_numChannels; ++i) {
-        int ch = m_channel + i;
-        if (ch > 512 || (i-1) >= m_channelNodes.size()) return;
-        level = m_listener->mergedLevels()[ch - 1].level;
-        m_channelNodes[i-1]->setValue(limit(0.0, level / 255.0, 1.0));
+    // the subscription contains exactly the channels of this fixture:
+    int count = m_subscription->count();
+    if (count < 1) return;
+    setValue(limit(0.0, m_subscription->level(0) / 255.0, 1.0));
+
+    for (int i=1; i<count; ++i) {
+        if ((i-1) >= m_channelNodes.size()) return;
+        m_channelNodes[i-1]->setValue(limit(0.0, m_subscription->level(i) / 255.0, 1.0));
     }
 }
 
 void VirtualFixtureBlock::updateListener() {
-    if (!m_listener.isNull()) {
-        disconnect(m_listener.data(), &sACNListener::levelsChanged, this, &VirtualFixtureBlock::onLevelsChanged);
-        m_listener.clear();
+    if (m_subscription) {
+        delete m_subscription;
+        m_subscription = nullptr;
     }
-    m_listener = sACNManager::getInstance()->getListener(m_universe);
-    connect(m_listener.data(), &sACNListener::levelsChanged, this, &VirtualFixtureBlock::onLevelsChanged);
+    // subscribe to the channels of this fixture only:
+    m_subscription = sACNManager::getInstance()->subscribe(m_universe, m_channel - 1, m_numChannels, this);
+    connect(m_subscription, &sACNRangeSubscription::levelsChanged, this, &VirtualFixtureBlock::onLevelsChanged);
     onLevelsChanged();
 }
 
@@ -4,7 +4,7 @@
 #include "core/block_data/OneOutputBlock.h"
 #include "core/SmartAttribute.h"
 
-class sACNListener;
+class sACNRangeSubscription;
 
 
 class VirtualFixtureBlock : public OneOutputBlock {
@@ -45,7 +45,8 @@ private slots:
     void updateNodeCount();
 
 protected:
-    QSharedPointer<sACNListener> m_listener;
+    // only receives the channels of this block, child of this block
+    sACNRangeSubscription* m_subscription;
 
     IntegerAttribute m_universe;
     IntegerAttribute m_channel;
@@ -0,0 +1,348 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "ColorKernels.h"
+
+#include "core/ColorKernelsImpl.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define COLOR_KERNELS_X86
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+static_assert(sizeof(HSV) == 3 * sizeof(double), "HSV must consist of exactly three doubles.");
+static_assert(sizeof(RGB) == 3 * sizeof(double), "RGB must consist of exactly three doubles.");
+
+
+namespace ColorKernels {
+
+#ifdef LUMINOSUS_AVX2_KERNELS
+// implemented in ColorKernelsAvx2.cpp, which is compiled with AVX2 enabled:
+// they only process complete blocks and return the number of processed pixels or values
+namespace Avx2 {
+    enum { lanesDouble = 4, lanesFloat = 8 };
+    int hsvToRgb(const double* src, double* dst, int count);
+    int hsvToRgb(const float* src, float* dst, int count);
+    int rgbToHsv(const double* src, double* dst, int count);
+    int rgbToHsv(const float* src, float* dst, int count);
+    int maxMerge(double* dst, const double* src, int values);
+    int maxMerge(float* dst, const float* src, int values);
+}
+#endif
+
+namespace {
+
+// ------------------------- Scalar -------------------------
+
+template<typename S>
+void scalarHsvToRgb(const S* src, S* dst, int count) {
+    for (int n = 0; n < count; ++n) {
+        S h, s, v, f, p, q, t, r, g, b;
+        h = src[3*n];
+        s = src[3*n+1];
+        v = src[3*n+2];
+        if (s == S(0)) {
+            dst[3*n] = v;
+            dst[3*n+1] = v;
+            dst[3*n+2] = v;
+            continue;
+        }
+        int i = int(h*6);
+        f = (h*6)-i;
+        p = v*(1-s);
+        q = v*(1-s*f);
+        t = v*(1-s*(1-f));
+        i = i % 6;
+        switch (i) {
+            case 0: r = v, g = t, b = p; break;
+            case 1: r = q, g = v, b = p; break;
+            case 2: r = p, g = v, b = t; break;
+            case 3: r = p, g = q, b = v; break;
+            case 4: r = t, g = p, b = v; break;
+            case 5: r = v, g = p, b = q; break;
+            default: r = 0, g = 0, b = 0; break;
+        }
+        dst[3*n] = r;
+        dst[3*n+1] = g;
+        dst[3*n+2] = b;
+    }
+}
+
+template<typename S>
+void scalarRgbToHsv(const S* src, S* dst, int count) {
+    for (int n = 0; n < count; ++n) {
+        S r, g, b, maxc, minc, h, s, delta;
+        r = src[3*n];
+        g = src[3*n+2];  // g and b swapped, see ColorKernels::rgbToHsv()
+        b = src[3*n+1];
+        maxc = std::max(std::max(r, g), b);
+        minc = std::min(std::min(r, g), b);
+        if (minc == maxc) {
+            dst[3*n] = 0;
+            dst[3*n+1] = 0;
+            dst[3*n+2] = maxc;
+            continue;
+        }
+        delta = maxc - minc;
+        s = delta / maxc;
+        if (r == maxc) {
+            h = (g-b) / delta;
+        } else if (g == maxc) {
+            h = 2 + (b-r) / delta;
+        } else {
+            h = 4 + (r-g) / delta;
+        }
+        h = std::fmod(h/6, S(1));
+        if (h < 0) {
+            h += 1;
+        }
+        dst[3*n] = h;
+        dst[3*n+1] = s;
+        dst[3*n+2] = maxc;
+    }
+}
+
+template<typename S>
+void scalarMaxMerge(S* dst, const S* src, int values) {
+    for (int i = 0; i < values; ++i) {
+        dst[i] = std::max(dst[i], src[i]);
+    }
+}
+
+// ------------------------- Vector with scalar tail -------------------------
+
+template<typename S, int Lanes, int (*Blocks)(const S*, S*, int)>
+void hsvToRgbWithTail(const S* src, S* dst, int count) {
+    int i = 0;
+    while (i < count) {
+        i += Blocks(src + 3 * i, dst + 3 * i, count - i);
+        if (i >= count) break;
+        // a block with a hue outside of [0, 1] or the remaining pixels:
+        const int n = std::min(Lanes, count - i);
+        scalarHsvToRgb(src + 3 * i, dst + 3 * i, n);
+        i += n;
+    }
+}
+
+template<typename S, int (*Blocks)(const S*, S*, int)>
+void rgbToHsvWithTail(const S* src, S* dst, int count) {
+    const int i = Blocks(src, dst, count);
+    scalarRgbToHsv(src + 3 * i, dst + 3 * i, count - i);
+}
+
+template<typename S, int (*Blocks)(S*, const S*, int)>
+void maxMergeWithTail(S* dst, const S* src, int values) {
+    const int i = Blocks(dst, src, values);
+    scalarMaxMerge(dst + i, src + i, values - i);
+}
+
+#ifdef COLOR_KERNELS_X86
+
+// SSE2 is part of every x86-64 CPU, these traits don't need a runtime check:
+
+struct Sse2Double {
+    typedef double S;
+    typedef __m128d V;
+    enum { lanes = 2 };
+
+    static V set1(S x) { return _mm_set1_pd(x); }
+    static V load(const S* p) { return _mm_load_pd(p); }
+    static void store(S* p, V a) { _mm_store_pd(p, a); }
+    static V loadu(const S* p) { return _mm_loadu_pd(p); }
+    static void storeu(S* p, V a) { _mm_storeu_pd(p, a); }
+    static V add(V a, V b) { return _mm_add_pd(a, b); }
+    static V sub(V a, V b) { return _mm_sub_pd(a, b); }
+    static V mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static V div(V a, V b) { return _mm_div_pd(a, b); }
+    static V min(V a, V b) { return _mm_min_pd(a, b); }
+    static V max(V a, V b) { return _mm_max_pd(a, b); }
+    static V cmpEq(V a, V b) { return _mm_cmpeq_pd(a, b); }
+    static V cmpLt(V a, V b) { return _mm_cmplt_pd(a, b); }
+    static V cmpLe(V a, V b) { return _mm_cmple_pd(a, b); }
+    static V andMask(V a, V b) { return _mm_and_pd(a, b); }
+    static bool allTrue(V mask) { return _mm_movemask_pd(mask) == 0x3; }
+    static V select(V mask, V a, V b) { return _mm_or_pd(_mm_and_pd(mask, b), _mm_andnot_pd(mask, a)); }
+};
+
+struct Sse2Float {
+    typedef float S;
+    typedef __m128 V;
+    enum { lanes = 4 };
+
+    static V set1(S x) { return _mm_set1_ps(x); }
+    static V load(const S* p) { return _mm_load_ps(p); }
+    static void store(S* p, V a) { _mm_store_ps(p, a); }
+    static V loadu(const S* p) { return _mm_loadu_ps(p); }
+    static void storeu(S* p, V a) { _mm_storeu_ps(p, a); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm_div_ps(a, b); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+    static V cmpEq(V a, V b) { return _mm_cmpeq_ps(a, b); }
+    static V cmpLt(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static V cmpLe(V a, V b) { return _mm_cmple_ps(a, b); }
+    static V andMask(V a, V b) { return _mm_and_ps(a, b); }
+    static bool allTrue(V mask) { return _mm_movemask_ps(mask) == 0xF; }
+    static V select(V mask, V a, V b) { return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a)); }
+};
+
+#endif  // COLOR_KERNELS_X86
+
+bool cpuSupportsAvx2() {
+#if defined(LUMINOSUS_AVX2_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(LUMINOSUS_AVX2_KERNELS) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osUsesXsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osUsesXsave || !avx) return false;
+    // check that the OS saves the YMM registers:
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+InstructionSet detectInstructionSet() {
+    if (cpuSupportsAvx2()) return InstructionSet::AVX2;
+#ifdef COLOR_KERNELS_X86
+    return InstructionSet::SSE2;
+#else
+    return InstructionSet::Scalar;
+#endif
+}
+
+struct KernelTable {
+    void (*hsvToRgbDouble)(const double*, double*, int);
+    void (*hsvToRgbFloat)(const float*, float*, int);
+    void (*rgbToHsvDouble)(const double*, double*, int);
+    void (*rgbToHsvFloat)(const float*, float*, int);
+    void (*maxMergeDouble)(double*, const double*, int);
+    void (*maxMergeFloat)(float*, const float*, int);
+};
+
+KernelTable createKernelTable(InstructionSet instructionSet) {
+    KernelTable table;
+    table.hsvToRgbDouble = &scalarHsvToRgb<double>;
+    table.hsvToRgbFloat = &scalarHsvToRgb<float>;
+    table.rgbToHsvDouble = &scalarRgbToHsv<double>;
+    table.rgbToHsvFloat = &scalarRgbToHsv<float>;
+    table.maxMergeDouble = &scalarMaxMerge<double>;
+    table.maxMergeFloat = &scalarMaxMerge<float>;
+
+    switch (instructionSet) {
+#ifdef LUMINOSUS_AVX2_KERNELS
+    case InstructionSet::AVX2:
+        table.hsvToRgbDouble = &hsvToRgbWithTail<double, Avx2::lanesDouble, &Avx2::hsvToRgb>;
+        table.hsvToRgbFloat = &hsvToRgbWithTail<float, Avx2::lanesFloat, &Avx2::hsvToRgb>;
+        table.rgbToHsvDouble = &rgbToHsvWithTail<double, &Avx2::rgbToHsv>;
+        table.rgbToHsvFloat = &rgbToHsvWithTail<float, &Avx2::rgbToHsv>;
+        table.maxMergeDouble = &maxMergeWithTail<double, &Avx2::maxMerge>;
+        table.maxMergeFloat = &maxMergeWithTail<float, &Avx2::maxMerge>;
+        break;
+#endif
+#ifdef COLOR_KERNELS_X86
+    case InstructionSet::SSE2:
+        table.hsvToRgbDouble = &hsvToRgbWithTail<double, Sse2Double::lanes, &vectorHsvToRgbBlocks<Sse2Double>>;
+        table.hsvToRgbFloat = &hsvToRgbWithTail<float, Sse2Float::lanes, &vectorHsvToRgbBlocks<Sse2Float>>;
+        table.rgbToHsvDouble = &rgbToHsvWithTail<double, &vectorRgbToHsvBlocks<Sse2Double>>;
+        table.rgbToHsvFloat = &rgbToHsvWithTail<float, &vectorRgbToHsvBlocks<Sse2Float>>;
+        table.maxMergeDouble = &maxMergeWithTail<double, &vectorMaxMergeBlocks<Sse2Double>>;
+        table.maxMergeFloat = &maxMergeWithTail<float, &vectorMaxMergeBlocks<Sse2Float>>;
+        break;
+#endif
+    default:
+        break;
+    }
+    return table;
+}
+
+struct Dispatcher {
+    Dispatcher()
+        : instructionSet(detectInstructionSet())
+        , kernels(createKernelTable(instructionSet))
+    {}
+
+    const InstructionSet instructionSet;
+    const KernelTable kernels;
+};
+
+const Dispatcher& dispatcher() {
+    // initialized once on first use (thread-safe since C++11):
+    static const Dispatcher instance;
+    return instance;
+}
+
+}  // namespace
+
+InstructionSet activeInstructionSet() {
+    return dispatcher().instructionSet;
+}
+
+const char* instructionSetName() {
+    switch (activeInstructionSet()) {
+    case InstructionSet::AVX2:
+        return "AVX2";
+    case InstructionSet::SSE2:
+        return "SSE2";
+    default:
+        return "Scalar";
+    }
+}
+
+void hsvToRgb(const HSV* src, RGB* dst, int count) {
+    dispatcher().kernels.hsvToRgbDouble(&src->h, &dst->r, count);
+}
+
+void hsvToRgb(const float* src, float* dst, int count) {
+    dispatcher().kernels.hsvToRgbFloat(src, dst, count);
+}
+
+void rgbToHsv(const RGB* src, HSV* dst, int count) {
+    dispatcher().kernels.rgbToHsvDouble(&src->r, &dst->h, count);
+}
+
+void rgbToHsv(const float* src, float* dst, int count) {
+    dispatcher().kernels.rgbToHsvFloat(src, dst, count);
+}
+
+void maxMerge(RGB* dst, const RGB* src, int count) {
+    dispatcher().kernels.maxMergeDouble(&dst->r, &src->r, count * 3);
+}
+
+void maxMerge(float* dst, const float* src, int count) {
+    dispatcher().kernels.maxMergeFloat(dst, src, count * 3);
+}
+
+}  // namespace ColorKernels
@@ -0,0 +1,86 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef COLORKERNELS_H
+#define COLORKERNELS_H
+
+#include "core/Matrix.h"
+
+
+/**
+ * The ColorKernels namespace contains the conversion and merge loops that run over
+ * whole pixel buffers (i.e. the contents of an HsvMatrix or RgbMatrix).
+ *
+ * Each function has a scalar, an SSE2 and an AVX2 implementation. The fastest one
+ * supported by the CPU is selected once at runtime.
+ * The float variants work on interleaved float triplets (h, s, v or r, g, b).
+ */
+namespace ColorKernels {
+
+enum class InstructionSet {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief activeInstructionSet returns the implementation used on this CPU
+ * @return the selected instruction set
+ */
+InstructionSet activeInstructionSet();
+
+/**
+ * @brief instructionSetName returns a readable name of the active implementation
+ * @return "Scalar", "SSE2" or "AVX2"
+ */
+const char* instructionSetName();
+
+/**
+ * @brief hsvToRgb converts count HSV pixels to RGB
+ * @param src source pixels
+ * @param dst destination pixels, must not overlap with src
+ * @param count number of pixels
+ */
+void hsvToRgb(const HSV* src, RGB* dst, int count);
+void hsvToRgb(const float* src, float* dst, int count);
+
+/**
+ * @brief rgbToHsv converts count RGB pixels to HSV
+ *
+ * Like ColorMatrix always did, the green and blue channel are read swapped.
+ * @param src source pixels
+ * @param dst destination pixels, must not overlap with src
+ * @param count number of pixels
+ */
+void rgbToHsv(const RGB* src, HSV* dst, int count);
+void rgbToHsv(const float* src, float* dst, int count);
+
+/**
+ * @brief maxMerge sets each channel of dst to the maximum of dst and src (HTP)
+ * @param dst pixels to merge into
+ * @param src pixels to merge from
+ * @param count number of pixels
+ */
+void maxMerge(RGB* dst, const RGB* src, int count);
+void maxMerge(float* dst, const float* src, int count);
+
+}  // namespace ColorKernels
+
+#endif // COLORKERNELS_H
@@ -0,0 +1,113 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// This file is compiled with AVX2 enabled (see AVX2_SOURCES in luminosus.pro).
+// Its functions must only be called after checking the CPU, see ColorKernels.cpp.
+// It must not include headers with inline functions (i.e. the standard library),
+// because the linker could use their AVX2 version everywhere. It only uses intrinsics,
+// the scalar code for the remaining pixels is in ColorKernels.cpp.
+
+#include "core/ColorKernelsImpl.h"
+
+#include <immintrin.h>
+
+
+namespace {
+
+struct Avx2Double {
+    typedef double S;
+    typedef __m256d V;
+    enum { lanes = 4 };
+
+    static V set1(S x) { return _mm256_set1_pd(x); }
+    static V load(const S* p) { return _mm256_load_pd(p); }
+    static void store(S* p, V a) { _mm256_store_pd(p, a); }
+    static V loadu(const S* p) { return _mm256_loadu_pd(p); }
+    static void storeu(S* p, V a) { _mm256_storeu_pd(p, a); }
+    static V add(V a, V b) { return _mm256_add_pd(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static V div(V a, V b) { return _mm256_div_pd(a, b); }
+    static V min(V a, V b) { return _mm256_min_pd(a, b); }
+    static V max(V a, V b) { return _mm256_max_pd(a, b); }
+    static V cmpEq(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static V cmpLt(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static V cmpLe(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static V andMask(V a, V b) { return _mm256_and_pd(a, b); }
+    static bool allTrue(V mask) { return _mm256_movemask_pd(mask) == 0xF; }
+    static V select(V mask, V a, V b) { return _mm256_blendv_pd(a, b, mask); }
+};
+
+struct Avx2Float {
+    typedef float S;
+    typedef __m256 V;
+    enum { lanes = 8 };
+
+    static V set1(S x) { return _mm256_set1_ps(x); }
+    static V load(const S* p) { return _mm256_load_ps(p); }
+    static void store(S* p, V a) { _mm256_store_ps(p, a); }
+    static V loadu(const S* p) { return _mm256_loadu_ps(p); }
+    static void storeu(S* p, V a) { _mm256_storeu_ps(p, a); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V cmpEq(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static V cmpLt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static V cmpLe(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static V andMask(V a, V b) { return _mm256_and_ps(a, b); }
+    static bool allTrue(V mask) { return _mm256_movemask_ps(mask) == 0xFF; }
+    static V select(V mask, V a, V b) { return _mm256_blendv_ps(a, b, mask); }
+};
+
+}  // namespace
+
+
+namespace ColorKernels {
+namespace Avx2 {
+
+int hsvToRgb(const double* src, double* dst, int count) {
+    return vectorHsvToRgbBlocks<Avx2Double>(src, dst, count);
+}
+
+int hsvToRgb(const float* src, float* dst, int count) {
+    return vectorHsvToRgbBlocks<Avx2Float>(src, dst, count);
+}
+
+int rgbToHsv(const double* src, double* dst, int count) {
+    return vectorRgbToHsvBlocks<Avx2Double>(src, dst, count);
+}
+
+int rgbToHsv(const float* src, float* dst, int count) {
+    return vectorRgbToHsvBlocks<Avx2Float>(src, dst, count);
+}
+
+int maxMerge(double* dst, const double* src, int values) {
+    return vectorMaxMergeBlocks<Avx2Double>(dst, src, values);
+}
+
+int maxMerge(float* dst, const float* src, int values) {
+    return vectorMaxMergeBlocks<Avx2Float>(dst, src, values);
+}
+
+}  // namespace Avx2
+}  // namespace ColorKernels
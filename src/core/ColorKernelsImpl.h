@@ -0,0 +1,165 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef COLORKERNELSIMPL_H
+#define COLORKERNELSIMPL_H
+
+// This file contains the generic vector loops of the ColorKernels.
+// It is included by ColorKernels.cpp and ColorKernelsAvx2.cpp, which provide the
+// vector traits for their instruction set.
+// The translation units are compiled with different instruction set flags. To make sure that
+// no code compiled with AVX2 is shared with the other one (i.e. as an inline function of
+// the standard library), everything here is in an anonymous namespace and this file must not
+// include any other header.
+
+
+namespace {
+
+// ------------------------- Vector -------------------------
+
+// A traits class T provides:
+// - typedefs S (scalar type) and V (vector type), enum lanes
+// - set1, load, store (aligned), loadu, storeu
+// - add, sub, mul, div, min, max
+// - cmpEq, cmpLt, cmpLe returning a mask, andMask, allTrue
+// - select(mask, a, b) returning mask ? b : a
+
+// The functions only process complete blocks of T::lanes pixels and return the number of
+// processed pixels, the remaining ones are converted by the scalar code in ColorKernels.cpp.
+
+template<typename T>
+int vectorHsvToRgbBlocks(const typename T::S* src, typename T::S* dst, int count) {
+    typedef typename T::S S;
+    typedef typename T::V V;
+    const int N = T::lanes;
+    const V zero = T::set1(0);
+    const V one = T::set1(1);
+    const V four = T::set1(4);
+    const V six = T::set1(6);
+    alignas(64) S h[N], s[N], v[N];
+
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        const S* in = src + 3 * i;
+        S* out = dst + 3 * i;
+        for (int k = 0; k < N; ++k) {
+            h[k] = in[3*k];
+            s[k] = in[3*k+1];
+            v[k] = in[3*k+2];
+        }
+        const V vh = T::load(h);
+        // hues outside of [0, 1] (and NaNs) are left to the scalar code
+        // to keep its exact wrapping behaviour:
+        if (!T::allTrue(T::andMask(T::cmpLe(zero, vh), T::cmpLe(vh, one)))) {
+            break;
+        }
+        const V vv = T::load(v);
+        const V vvs = T::mul(vv, T::load(s));
+        const V h6 = T::mul(vh, six);
+
+        // channel = v - v*s * clamp(min(k, 4 - k), 0, 1) with k = (n + 6h) mod 6
+        // and n = 5 for red, 3 for green and 1 for blue:
+        V channels[3];
+        const S offsets[3] = {5, 3, 1};
+        for (int c = 0; c < 3; ++c) {
+            V k = T::add(T::set1(offsets[c]), h6);
+            k = T::select(T::cmpLe(six, k), k, T::sub(k, six));
+            V t = T::min(T::min(k, T::sub(four, k)), one);
+            t = T::max(t, zero);
+            channels[c] = T::sub(vv, T::mul(vvs, t));
+        }
+        T::store(h, channels[0]);
+        T::store(s, channels[1]);
+        T::store(v, channels[2]);
+        for (int k = 0; k < N; ++k) {
+            out[3*k] = h[k];
+            out[3*k+1] = s[k];
+            out[3*k+2] = v[k];
+        }
+    }
+    return i;
+}
+
+template<typename T>
+int vectorRgbToHsvBlocks(const typename T::S* src, typename T::S* dst, int count) {
+    typedef typename T::S S;
+    typedef typename T::V V;
+    const int N = T::lanes;
+    const V zero = T::set1(0);
+    const V one = T::set1(1);
+    const V two = T::set1(2);
+    const V four = T::set1(4);
+    const V six = T::set1(6);
+    alignas(64) S r[N], g[N], b[N];
+
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        const S* in = src + 3 * i;
+        S* out = dst + 3 * i;
+        for (int k = 0; k < N; ++k) {
+            r[k] = in[3*k];
+            g[k] = in[3*k+2];  // g and b swapped, see ColorKernels::rgbToHsv()
+            b[k] = in[3*k+1];
+        }
+        const V vr = T::load(r);
+        const V vg = T::load(g);
+        const V vb = T::load(b);
+        const V maxc = T::max(T::max(vr, vg), vb);
+        const V minc = T::min(T::min(vr, vg), vb);
+        const V delta = T::sub(maxc, minc);
+        // lanes with delta == 0 produce NaN here, they are replaced below:
+        V s = T::div(delta, maxc);
+        const V hr = T::div(T::sub(vg, vb), delta);
+        const V hg = T::add(two, T::div(T::sub(vb, vr), delta));
+        const V hb = T::add(four, T::div(T::sub(vr, vg), delta));
+        V h = T::select(T::cmpEq(vg, maxc), hb, hg);
+        h = T::select(T::cmpEq(vr, maxc), h, hr);
+        // h / 6 is always in (-1, 1), so fmod(h / 6, 1) is not necessary:
+        h = T::div(h, six);
+        h = T::select(T::cmpLt(h, zero), h, T::add(h, one));
+        const V gray = T::cmpEq(minc, maxc);
+        h = T::select(gray, h, zero);
+        s = T::select(gray, s, zero);
+
+        T::store(r, h);
+        T::store(g, s);
+        T::store(b, maxc);
+        for (int k = 0; k < N; ++k) {
+            out[3*k] = r[k];
+            out[3*k+1] = g[k];
+            out[3*k+2] = b[k];
+        }
+    }
+    return i;
+}
+
+template<typename T>
+int vectorMaxMergeBlocks(typename T::S* dst, const typename T::S* src, int values) {
+    const int N = T::lanes;
+    int i = 0;
+    for (; i + N <= values; i += N) {
+        T::storeu(dst + i, T::max(T::loadu(dst + i), T::loadu(src + i)));
+    }
+    return i;
+}
+
+}  // namespace
+
+#endif // COLORKERNELSIMPL_H
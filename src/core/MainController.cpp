@@ -54,6 +54,7 @@ MainController::MainController(QQmlApplicationEngine& qmlEngine, QString templat
     qmlRegisterType<GuiManager>();
     qmlRegisterType<LogManager>();
     qmlRegisterType<Engine>();
+    qmlRegisterType<FrameProfiler>();
     qmlRegisterType<AudioEngine>();
 	qmlRegisterType<OutputManager>();
 	qmlRegisterType<FileSystemManager>();
@@ -61,6 +62,7 @@ MainController::MainController(QQmlApplicationEngine& qmlEngine, QString templat
 	qmlRegisterType<PowermateListener>();
 	qmlRegisterType<MidiManager>();
 	qmlRegisterType<OSCNetworkManager>();
+	qmlRegisterType<OSCConnectionTelemetry>();
     qmlRegisterType<EosOSCManager>();
     qmlRegisterType<HogOSCManager>();
 	qmlRegisterType<ProjectManager>();
@@ -78,6 +80,7 @@ MainController::MainController(QQmlApplicationEngine& qmlEngine, QString templat
     QQmlEngine::setObjectOwnership(&m_guiManager, QQmlEngine::CppOwnership);
     QQmlEngine::setObjectOwnership(&m_logManager, QQmlEngine::CppOwnership);
     QQmlEngine::setObjectOwnership(&m_engine, QQmlEngine::CppOwnership);
+    QQmlEngine::setObjectOwnership(m_engine.profiler(), QQmlEngine::CppOwnership);
     QQmlEngine::setObjectOwnership(m_audioEngine, QQmlEngine::CppOwnership);
     QQmlEngine::setObjectOwnership(&m_output, QQmlEngine::CppOwnership);
 	QQmlEngine::setObjectOwnership(&m_dao, QQmlEngine::CppOwnership);
@@ -111,6 +114,11 @@ MainController::MainController(QQmlApplicationEngine& qmlEngine, QString templat
     connect(&m_powermate, SIGNAL(released(double)), this, SLOT(onControllerReleased(double)));
     m_powermate.start();
 
+    // send the OSC messages of each frame at once:
+    connect(&m_engine, SIGNAL(updateOutput(double)), &m_customOsc, SLOT(flushOutgoingMessages()));
+    connect(&m_engine, SIGNAL(updateOutput(double)), &m_lightingConsoleConnection, SLOT(flushOutgoingMessages()));
+    connect(&m_engine, SIGNAL(updateOutput(double)), &m_audioConsoleConnection, SLOT(flushOutgoingMessages()));
+
     // start App engine (for luminosus business logic):
     m_engine.start();
 
@@ -145,6 +153,8 @@ void MainController::saveAll() {
     appState["developerMode"] = getDeveloperMode();
     appState["clickSounds"] = getClickSounds();
     appState["outputManager"] = m_output.getState();
+    appState["engine"] = m_engine.getState();
+    appState["deferredNodeEvaluation"] = m_blockManager.getDeferredEvaluation();
     m_dao.saveFile("", "autosave.ats", appState);
 
 	m_projectManager.saveCurrentProject();
@@ -179,6 +189,8 @@ void MainController::restoreApp() {
     setDeveloperMode(appState["developerMode"].toBool());
     setClickSounds(appState["clickSounds"].toBool());
     m_output.setState(appState["outputManager"].toObject());
+    m_engine.setState(appState["engine"].toObject());
+    m_blockManager.setDeferredEvaluation(appState["deferredNodeEvaluation"].toBool());
 #ifndef Q_OS_ANDROID
     if (lockExisted && !m_forceImport) {
 #else
@@ -20,7 +20,10 @@
 
 #include "core/Matrix.h"
 
+#include "core/ColorKernels.h"
+
 #include <QDebug>
+#include <algorithm>
 #include <cmath>
 
 // ---------------------------- HSV ----------------------------
@@ -30,7 +33,7 @@ HsvMatrix::HsvMatrix()
 { }
 
 HsvMatrix::HsvMatrix(int width, int height)
-    : m_data(qMax(1, width), QVector<HSV>(qMax(1, height)))
+    : m_data(qMax(1, width) * qMax(1, height))
     , m_width(qMax(1, width))
     , m_height(qMax(1, height))
 {
@@ -52,25 +55,23 @@ void HsvMatrix::rescale(int width, int height) {
     width = qMax(1, width);
     height = qMax(1, height);
 
-    // change width:
-    m_data.resize(width);
-
-    // for all columns:
-    for (int x = 0; x < width; ++x) {
-        // change height:
-        m_data[x].resize(height);
+    if (height == m_height) {
+        // columns are contiguous, they can simply be appended or removed:
+        m_data.resize(width * height);
+    } else {
+        // keep the overlapping part at the same positions:
+        std::vector<HSV, AlignedAllocator<HSV>> newData(width * height);
+        const int minWidth = qMin(m_width, width);
+        const int minHeight = qMin(m_height, height);
+        for (int x = 0; x < minWidth; ++x) {
+            std::copy(m_data.begin() + x * m_height,
+                      m_data.begin() + x * m_height + minHeight,
+                      newData.begin() + x * height);
+        }
+        m_data.swap(newData);
     }
     m_width = width;
     m_height = height;
-
-    // postcondition check because this operation
-    if (m_width < 1 || m_height < 1 || m_data.size() != m_width || m_data[0].size() != m_height) {
-        if (m_data.size() < 1) {
-            qCritical() << "Matrix resize failed.";
-        }
-        qCritical() << "Matrix resize failed (target: " << width << "x" << height
-                    << ", actual:" << m_data.size() << "x" << m_data[0].size() << ")";
-    }
 }
 
 void HsvMatrix::rescale(const Size& s) {
@@ -86,19 +87,23 @@ void HsvMatrix::expandTo(const Size& s) {
 }
 
 void HsvMatrix::setFrom(const HsvMatrix& other) {
+    if (hasSameSizeAs(other)) {
+        std::copy(other.m_data.begin(), other.m_data.end(), m_data.begin());
+        return;
+    }
     int minWidth = qMin(m_width, other.m_width);
     int minHeight = qMin(m_height, other.m_height);
     for (int x=0; x<minWidth; ++x) {
-        for (int y=0; y<minHeight; ++y) {
-            m_data[x][y] = other.m_data[x][y];
-        }
+        std::copy(other.m_data.begin() + x * other.m_height,
+                  other.m_data.begin() + x * other.m_height + minHeight,
+                  m_data.begin() + x * m_height);
     }
 }
 
 void HsvMatrix::fadeTo(const HsvMatrix& other, double pos) {
     for (int x=0; x < m_width; ++x) {
         for (int y=0; y < m_height; ++y) {
-            HSV& col = m_data[x][y];
+            HSV& col = atUnchecked(x, y);
             const HSV& colOther = other.at(x, y);
             col.h = col.h * (1 - pos) + colOther.h * pos;
             col.s = col.s * (1 - pos) + colOther.s * pos;
@@ -114,7 +119,7 @@ RgbMatrix::RgbMatrix()
 { }
 
 RgbMatrix::RgbMatrix(int width, int height)
-    : m_data(qMax(1, width), QVector<RGB>(qMax(1, height)))
+    : m_data(qMax(1, width) * qMax(1, height))
     , m_width(qMax(1, width))
     , m_height(qMax(1, height))
 {
@@ -136,25 +141,23 @@ void RgbMatrix::rescale(int width, int height) {
     width = qMax(1, width);
     height = qMax(1, height);
 
-    // change width:
-    m_data.resize(width);
-
-    // for all columns:
-    for (int x = 0; x < width; ++x) {
-        // change height:
-        m_data[x].resize(height);
+    if (height == m_height) {
+        // columns are contiguous, they can simply be appended or removed:
+        m_data.resize(width * height);
+    } else {
+        // keep the overlapping part at the same positions:
+        std::vector<RGB, AlignedAllocator<RGB>> newData(width * height);
+        const int minWidth = qMin(m_width, width);
+        const int minHeight = qMin(m_height, height);
+        for (int x = 0; x < minWidth; ++x) {
+            std::copy(m_data.begin() + x * m_height,
+                      m_data.begin() + x * m_height + minHeight,
+                      newData.begin() + x * height);
+        }
+        m_data.swap(newData);
     }
     m_width = width;
     m_height = height;
-
-    // postcondition check because this operation
-    if (m_width < 1 || m_height < 1 || m_data.size() != m_width || m_data[0].size() != m_height) {
-        if (m_data.size() < 1) {
-            qCritical() << "Matrix resize failed.";
-        }
-        qCritical() << "Matrix resize failed (target: " << width << "x" << height
-                    << ", actual:" << m_data.size() << "x" << m_data[0].size() << ")";
-    }
 }
 
 void RgbMatrix::rescale(const Size& s) {
@@ -170,50 +173,65 @@ void RgbMatrix::expandTo(const Size& s) {
 }
 
 void RgbMatrix::setFrom(const RgbMatrix& other) {
+    if (hasSameSizeAs(other)) {
+        std::copy(other.m_data.begin(), other.m_data.end(), m_data.begin());
+        return;
+    }
     int minWidth = qMin(m_width, other.m_width);
     int minHeight = qMin(m_height, other.m_height);
     for (int x=0; x<minWidth; ++x) {
-        for (int y=0; y<minHeight; ++y) {
-            m_data[x][y] = other.m_data[x][y];
-        }
+        std::copy(other.m_data.begin() + x * other.m_height,
+                  other.m_data.begin() + x * other.m_height + minHeight,
+                  m_data.begin() + x * m_height);
     }
 }
 
 void RgbMatrix::addHtp(const RgbMatrix& other) {
+    if (hasSameSizeAs(other)) {
+        ColorKernels::maxMerge(data(), other.data(), pixelCount());
+        return;
+    }
     int minWidth = qMin(m_width, other.m_width);
     int minHeight = qMin(m_height, other.m_height);
     for (int x=0; x<minWidth; ++x) {
         for (int y=0; y<minHeight; ++y) {
-            m_data[x][y].mixHtp(other.m_data[x][y]);
+            atUnchecked(x, y).mixHtp(other.atUnchecked(x, y));
         }
     }
 }
 
 QDataStream& operator<<(QDataStream& out, const HsvMatrix& matrix) {
-    out << matrix.m_data;
+    // written in the format of the former QVector<QVector<HSV>> storage
+    // to stay compatible with saved projects:
+    out << quint32(matrix.m_width);
+    for (int x = 0; x < matrix.m_width; ++x) {
+        out << quint32(matrix.m_height);
+        for (int y = 0; y < matrix.m_height; ++y) {
+            out << matrix.atUnchecked(x, y);
+        }
+    }
     out << matrix.m_width;
     out << matrix.m_height;
     return out;
 }
 
 QDataStream& operator>>(QDataStream& in, HsvMatrix& matrix) {
-    in >> matrix.m_data;
-    in >> matrix.m_width;
-    in >> matrix.m_height;
+    QVector< QVector< HSV > > columns;
+    in >> columns;
+    int width = 1;
+    int height = 1;
+    in >> width;
+    in >> height;
 
     // make sure matrix has correct size even if not restored correctly:
-    matrix.m_width = qMax(matrix.m_width, 1);
-    matrix.m_height = qMax(matrix.m_height, 1);
-
-    // change width:
-    matrix.m_data.resize(matrix.m_width);
+    matrix = HsvMatrix(width, height);
 
-    // for all columns:
-    for (int x = 0; x < matrix.m_width; ++x) {
-        // change height:
-        matrix.m_data[x].resize(matrix.m_height);
+    for (int x = 0; x < qMin(columns.size(), matrix.m_width); ++x) {
+        const QVector<HSV>& column = columns[x];
+        for (int y = 0; y < qMin(column.size(), matrix.m_height); ++y) {
+            matrix.atUnchecked(x, y) = column[y];
+        }
     }
-
     return in;
 }
 
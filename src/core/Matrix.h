@@ -24,6 +24,10 @@
 #include <QVector>
 #include <QDataStream>
 
+#include <vector>
+#include <cstddef>
+#include <new>
+
 // ------------------------ Basic Structs ---------------------
 
 struct RGB;
@@ -99,6 +103,62 @@ struct Size {
 };
 
 
+// ------------------------ Storage ---------------------
+
+namespace MatrixConstants {
+    // alignment of the pixel buffer in bytes, suitable for AVX loads and cache lines:
+    static const std::size_t bufferAlignment = 64;
+}
+
+/**
+ * @brief The AlignedAllocator class is a minimal std allocator that returns memory
+ * aligned to MatrixConstants::bufferAlignment.
+ */
+template<typename T>
+class AlignedAllocator {
+
+public:
+    typedef T value_type;
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        void* p = qMallocAligned(n * sizeof(T), MatrixConstants::bufferAlignment);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, std::size_t) {
+        qFreeAligned(p);
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+/**
+ * @brief The MatrixSpan struct is a non-owning view of one row or column of a matrix.
+ * It stays valid until the matrix is rescaled or destroyed.
+ */
+template<typename T>
+struct MatrixSpan {
+    MatrixSpan(T* data, int size, int stride) : m_data(data), m_size(size), m_stride(stride) {}
+
+    T& operator[](int i) const { return m_data[i * m_stride]; }
+    int size() const { return m_size; }
+    int stride() const { return m_stride; }
+    T* data() const { return m_data; }
+
+protected:
+    T* m_data;
+    int m_size;
+    int m_stride;
+};
+
+
 // ----------------------- HSV ------------------------
 
 class HsvMatrix {
@@ -130,8 +190,25 @@ public:
 
     // ---- Getter + Setter:
 
-    HSV& at(int x, int y) { return m_data[abs(x % m_width)][abs(y % m_height)]; }
-    const HSV& at(int x, int y) const { return m_data[abs(x % m_width)][abs(y % m_height)]; }
+    // at() wraps around positions outside of the matrix:
+    HSV& at(int x, int y) { return m_data[abs(x % m_width) * m_height + abs(y % m_height)]; }
+    const HSV& at(int x, int y) const { return m_data[abs(x % m_width) * m_height + abs(y % m_height)]; }
+
+    // atUnchecked() requires 0 <= x < width and 0 <= y < height:
+    HSV& atUnchecked(int x, int y) { return m_data[x * m_height + y]; }
+    const HSV& atUnchecked(int x, int y) const { return m_data[x * m_height + y]; }
+
+    // ---- Raw access:
+    // pixels are stored contiguous in column-major order (index = x * height + y)
+
+    HSV* data() { return m_data.data(); }
+    const HSV* data() const { return m_data.data(); }
+    int pixelCount() const { return m_width * m_height; }
+
+    MatrixSpan<HSV> column(int x) { return MatrixSpan<HSV>(data() + x * m_height, m_height, 1); }
+    MatrixSpan<const HSV> column(int x) const { return MatrixSpan<const HSV>(data() + x * m_height, m_height, 1); }
+    MatrixSpan<HSV> row(int y) { return MatrixSpan<HSV>(data() + y, m_width, m_height); }
+    MatrixSpan<const HSV> row(int y) const { return MatrixSpan<const HSV>(data() + y, m_width, m_height); }
 
     void setFrom(const HsvMatrix& other);
 
@@ -149,7 +226,7 @@ public:
 
 
 protected:
-    QVector< QVector< HSV > > m_data;
+    std::vector<HSV, AlignedAllocator<HSV>> m_data;
     int m_width;
     int m_height;
 };
@@ -186,8 +263,25 @@ public:
 
     // ---- Getter + Setter:
 
-    RGB& at(int x, int y) { return m_data[abs(x % m_width)][abs(y % m_height)]; }
-    const RGB& at(int x, int y) const { return m_data[abs(x % m_width)][abs(y % m_height)]; }
+    // at() wraps around positions outside of the matrix:
+    RGB& at(int x, int y) { return m_data[abs(x % m_width) * m_height + abs(y % m_height)]; }
+    const RGB& at(int x, int y) const { return m_data[abs(x % m_width) * m_height + abs(y % m_height)]; }
+
+    // atUnchecked() requires 0 <= x < width and 0 <= y < height:
+    RGB& atUnchecked(int x, int y) { return m_data[x * m_height + y]; }
+    const RGB& atUnchecked(int x, int y) const { return m_data[x * m_height + y]; }
+
+    // ---- Raw access:
+    // pixels are stored contiguous in column-major order (index = x * height + y)
+
+    RGB* data() { return m_data.data(); }
+    const RGB* data() const { return m_data.data(); }
+    int pixelCount() const { return m_width * m_height; }
+
+    MatrixSpan<RGB> column(int x) { return MatrixSpan<RGB>(data() + x * m_height, m_height, 1); }
+    MatrixSpan<const RGB> column(int x) const { return MatrixSpan<const RGB>(data() + x * m_height, m_height, 1); }
+    MatrixSpan<RGB> row(int y) { return MatrixSpan<RGB>(data() + y, m_width, m_height); }
+    MatrixSpan<const RGB> row(int y) const { return MatrixSpan<const RGB>(data() + y, m_width, m_height); }
 
     void setFrom(const RgbMatrix& other);
     void addHtp(const RgbMatrix& other);
@@ -201,7 +295,7 @@ public:
 
 
 protected:
-    QVector< QVector< RGB > > m_data;
+    std::vector<RGB, AlignedAllocator<RGB>> m_data;
     int m_width;
     int m_height;
 };
@@ -4,9 +4,68 @@
 #include "core/Matrix.h"
 
 #include <QSize>
+#include <QSharedData>
 #include <vector>
 #include <cmath>
 
+/**
+ * @brief The ColorMatrixData struct contains the data of a ColorMatrix.
+ *
+ * It is shared between copies of a ColorMatrix until one of them is modified
+ * (copy-on-write). Because all sharing copies are in the same state, the cached
+ * conversions are written directly into the shared data.
+ */
+struct ColorMatrixData : public QSharedData {
+
+    ColorMatrixData();
+
+    /**
+     * @brief width is the width of the matrix [1...INT_MAX]
+     */
+    int width;
+    /**
+     * @brief height is the height of the matrix [1...INT_MAX]
+     */
+    int height;
+
+    /**
+     * @brief hsvData stores the data as HSV values (this is not always up to date)
+     */
+    HsvMatrix hsvData;
+    /**
+     * @brief hsvIsValid is true, if the HSV values are up to date
+     */
+    bool hsvIsValid;
+    /**
+     * @brief rgbData stores the data as RGB values (this is not always up to date)
+     */
+    RgbMatrix rgbData;
+    /**
+     * @brief rgbIsValid is true, if the RGB values are up to date
+     */
+    bool rgbIsValid;
+    /**
+     * @brief value stores the first value of the data (because it is very often used)
+     * (this is not always up to date)
+     */
+    double value;
+    /**
+     * @brief valueIsValid is true, if "value" is up to date
+     */
+    bool valueIsValid;
+
+    /**
+     * @brief absoluteMaximum stores the maximum absolute value to be multiplied with
+     * the relative values (it is only valid if absoluteMaximumIsProvided is true)
+     */
+    double absoluteMaximum;
+    /**
+     * @brief absoluteMaximumIsProvided is true, if the absoluteValue is set and valid
+     */
+    bool absoluteMaximumIsProvided;
+};
+
+
 /**
  * @brief The ColorMatrix struct can store a 2D matrix of color values.
  *
@@ -14,6 +73,7 @@
  * It can also be effeciently used to get and store a single 1D value,
  * that is only converted when necessary to RGB or HSV values.
  * The size of the matrix can be changed anytime.
+ * Copies are cheap, they share the data until one of them is modified.
  */
 struct ColorMatrix {
 
@@ -52,7 +112,7 @@ struct ColorMatrix {
      * @return width
      */
     int width() const {
-        return m_width;
+        return d->width;
     }
 
     /**
@@ -60,7 +120,7 @@ struct ColorMatrix {
      * @return height
      */
     int height() const {
-        return m_height;
+        return d->height;
     }
 
     QSize getSize() const {
@@ -106,10 +166,11 @@ struct ColorMatrix {
      * @param newHsv an array of HSV values  [0-1]
      */
     void setHsv(const HsvMatrix& newHsv) {
-        m_hsvData = newHsv;
-        m_hsvIsValid = true;
-        m_rgbIsValid = false;
-        m_valueIsValid = false;
+        d.detach();
+        d->hsvData = newHsv;
+        d->hsvIsValid = true;
+        d->rgbIsValid = false;
+        d->valueIsValid = false;
     }
 
     /**
@@ -128,8 +189,8 @@ struct ColorMatrix {
      * @return array of HSV values
      */
     const HsvMatrix& getHsv() const {
-        if (!m_hsvIsValid) updateHsv();
-        return m_hsvData;
+        if (!d->hsvIsValid) updateHsv();
+        return d->hsvData;
     }
 
     /**
@@ -139,8 +200,8 @@ struct ColorMatrix {
      * @return HSV values
      */
     HSV getHsvAt(int x, int y) const {
-        if (!m_hsvIsValid) updateHsv();
-        return m_hsvData.at(x, y);
+        if (!d->hsvIsValid) updateHsv();
+        return d->hsvData.at(x, y);
     }
 
     // ---------- RGB -------------
@@ -175,8 +236,8 @@ struct ColorMatrix {
      * @return array of HSV values
      */
     const RgbMatrix& getRgb() const {
-        if (!m_rgbIsValid) updateRgb();
-        return m_rgbData;
+        if (!d->rgbIsValid) updateRgb();
+        return d->rgbData;
     }
 
     /**
@@ -186,8 +247,8 @@ struct ColorMatrix {
      * @return RGB values
      */
     RGB getRgbAt(int x, int y) const {
-        if (!m_rgbIsValid) updateRgb();
-        return m_rgbData.at(x, y);
+        if (!d->rgbIsValid) updateRgb();
+        return d->rgbData.at(x, y);
     }
 
 //    /**
@@ -241,18 +302,18 @@ struct ColorMatrix {
      * @brief getAbsoluteMaximum returns the absolute maximum value
      * @return the maximal absolute value
      */
-    double getAbsoluteMaximum() const { return m_absoluteMaximum; }
+    double getAbsoluteMaximum() const { return d->absoluteMaximum; }
 
     /**
      * @brief absoluteMaximumIsProvided return if an absolute maximum value is provided
      * @return true if absolute maximum value is provided
      */
-    bool absoluteMaximumIsProvided() const { return m_absoluteMaximumIsProvided; }
+    bool absoluteMaximumIsProvided() const { return d->absoluteMaximumIsProvided; }
 
     /**
      * @brief resetAbsoluteMaximum resets absolute maximum value
      */
-    void resetAbsoluteMaximum() { m_absoluteMaximumIsProvided = false; }
+    void resetAbsoluteMaximum() { d.detach(); d->absoluteMaximumIsProvided = false; }
 
 protected:
     /**
@@ -278,50 +339,10 @@ protected:
     // -------------- member attributes ----------------
 
     /**
-     * @brief m_width is the width of the matrix [1...INT_MAX]
-     */
-    int m_width;
-    /**
-     * @brief m_height is the height of the matrix [1...INT_MAX]
-     */
-    int m_height;
-
-    /**
-     * @brief m_hsvData stores the data as HSV values (this is not always up to date)
-     */
-    mutable HsvMatrix m_hsvData;
-    /**
-     * @brief m_hsvIsValid is true, if the HSV values are up to date
-     */
-    mutable bool m_hsvIsValid;
-    /**
-     * @brief m_rgbData stores the data as RGB values (this is not always up to date)
-     */
-    mutable RgbMatrix m_rgbData;
-    /**
-     * @brief m_rgbIsValid is true, if the RGB values are up to date
-     */
-    mutable bool m_rgbIsValid;
-    /**
-     * @brief m_value stores the first value of the data (because it is very often used)
-     * (this is not always up to date)
-     */
-    mutable double m_value;
-    /**
-     * @brief m_valueIsValid is true, if "m_value" is up to date
-     */
-    mutable bool m_valueIsValid;
-
-    /**
-     * @brief m_absoluteMaximum stores the maximum absolute value to be multiplied with
-     * the relative values (it is only valid if m_absoluteMaximumProvided is true)
-     */
-    mutable double m_absoluteMaximum;
-
-    /**
-     * @brief m_absoluteMaximumIsProvided is true, if the absoluteValue is set and valid
+     * @brief d points to the (possibly shared) data,
+     * all non-const methods have to call d.detach() before modifying it
      */
-    mutable bool m_absoluteMaximumIsProvided;
+    QExplicitlySharedDataPointer<ColorMatrixData> d;
 
 //    /**
 //     * @brief m_offsetX offset on x-axis to read from (i.e. because the values before that
@@ -2,11 +2,15 @@
 
 #include "core/block_data/BlockInterface.h"
 #include "core/MainController.h"  // for LuminosusConstants
+#include "core/manager/FrameProfiler.h"
 
 // ------------------------ NodeBase -----------------------------------------------------------
 
 // initialize static member attributes:
 QPointer<NodeBase> NodeBase::s_focusedNode = nullptr;
+bool NodeBase::s_deferredPropagation = false;
+quint64 NodeBase::s_topologyVersion = 0;
+QVector<QPointer<NodeBase>> NodeBase::s_dirtyInputs;
 
 NodeBase::NodeBase(BlockInterface* block, int index, bool isOutput)
     : QObject(block)
@@ -21,6 +25,10 @@ NodeBase::NodeBase(BlockInterface* block, int index, bool isOutput)
     , m_isActive(true)
     , m_htp(true)
     , m_impulseActive(false)
+    , m_dirty(false)
+    , m_batchDepth(0)
+    , m_modifiedInBatch(false)
+    , m_ltpSource(nullptr)
     , m_requestedSize(1, 1)
     , m_data()
 {
@@ -97,6 +105,7 @@ void NodeBase::connectTo(NodeBase* otherNode) {
 
     outputNode->m_connectedNodes.append(inputNode);
     inputNode->m_connectedNodes.append(outputNode);
+    ++s_topologyVersion;
     // TODO: create Bezier Curve
 
     outputNode->updateRequestedSize();
@@ -148,6 +157,7 @@ void NodeBase::disconnectFrom(NodeBase* otherNode) {
 
     outputNode->m_connectedNodes.removeOne(inputNode);
     inputNode->m_connectedNodes.removeOne(outputNode);
+    ++s_topologyVersion;
 
     // check if requested Size changed in output node because of disconnect:
     outputNode->updateRequestedSize();
@@ -307,12 +317,42 @@ void NodeBase::dataWasModifiedByBlock() {
         qCritical() << "Method dataWasModifiedByBlock() is only available for output nodes.";
         return;
     }
+    if (m_batchDepth > 0) {
+        // connected nodes will be notified once when the batch ends:
+        m_modifiedInBatch = true;
+        return;
+    }
+    if (s_deferredPropagation) {
+        // only mark the inputs as dirty, they are evaluated by the BlockManager once per frame:
+        for (NodeBase* inputNode: m_connectedNodes) {
+            if (!inputNode) continue;
+            inputNode->markDirty(this);
+        }
+        return;
+    }
+    ProfilerScope profilerScope(m_block, FrameProfiler::DataCascade);
     for (NodeBase* inputNode: m_connectedNodes) {
         if (!inputNode) continue;
         inputNode->updateData(this);
     }
 }
 
+void NodeBase::beginBatch() {
+    ++m_batchDepth;
+}
+
+void NodeBase::endBatch() {
+    if (m_batchDepth <= 0) {
+        qCritical() << "NodeBase::endBatch() called without matching beginBatch().";
+        return;
+    }
+    --m_batchDepth;
+    if (m_batchDepth == 0 && m_modifiedInBatch) {
+        m_modifiedInBatch = false;
+        dataWasModifiedByBlock();
+    }
+}
+
 void NodeBase::sendImpulse() {
     setValue(1.0);
     m_impulseTimer.start();
@@ -386,47 +426,71 @@ void NodeBase::setOutputBackToZero() {
 bool NodeBase::cycleCheck(NodeBase* outputNode, NodeBase* inputNode) {
     if (!outputNode || !inputNode) return false;
     QString uid = outputNode->getBlock()->getUid();
-    return cycleCheckRecursive(uid, inputNode, 0);
+    return cycleCheckRecursive(uid, inputNode->getBlock(), 0);
 }
 
-bool NodeBase::cycleCheckRecursive(QString uid, NodeBase* inputNode, int depth) {
-    if (!inputNode) return false;
+bool NodeBase::cycleCheckRecursive(QString uid, BlockInterface* block, int depth) {
+    if (!block) return false;
     if (depth > 1000) {
         // too many recursion steps, somthing is wrong
         return true;
     }
 
-    // check if the block of this input node is the block we are looking for:
-    BlockInterface* block = inputNode->getBlock();
-    if (!block) return false;
+    // check if this block is the block we are looking for:
     if (block->getUid() == uid) {
         // -> cycle detected!
         // cancel condition of recursion
         return true;
     }
 
-    // continue cycle check the nodes, that are connected to the output nodes
+    // continue cycle check with the blocks, that are connected to the output nodes
     // of this block:
+    for (BlockInterface* nextBlock: getDownstreamBlocks(block)) {
+        bool cycle = cycleCheckRecursive(uid, nextBlock, ++depth);
+        if (cycle) return true;
+    }
+    return false;
+}
 
-    QList<QPointer<NodeBase>> nodes = block->getNodes();
-
-    for (NodeBase* node: nodes) {
+QVector<BlockInterface*> NodeBase::getDownstreamBlocks(BlockInterface* block) {
+    QVector<BlockInterface*> blocks;
+    if (!block) return blocks;
+    for (NodeBase* node: block->getNodes()) {
         if (!node) continue;
         if (!node->isOutput()) continue;
-        // -> node is output
-        auto connectedInputNodes = node->getConnectedNodes();
-        for (NodeBase* nextInput: connectedInputNodes) {
+        for (NodeBase* nextInput: node->getConnectedNodes()) {
             if (!nextInput) continue;
-            bool cycle = cycleCheckRecursive(uid, nextInput, ++depth);
-            if (cycle) return true;
+            BlockInterface* nextBlock = nextInput->getBlock();
+            if (!nextBlock) continue;
+            blocks.append(nextBlock);
         }
     }
-    return false;
+    return blocks;
+}
+
+QVector<QPointer<NodeBase>> NodeBase::takeDirtyInputs() {
+    QVector<QPointer<NodeBase>> dirtyInputs;
+    dirtyInputs.swap(s_dirtyInputs);
+    return dirtyInputs;
+}
+
+void NodeBase::updateIfDirty() {
+    if (!m_dirty) return;
+    m_dirty = false;
+    updateData(m_ltpSource);
+    m_ltpSource = nullptr;
 }
 
 
 // ------ internal logic of Input Node:
 
+void NodeBase::markDirty(NodeBase* ltpSource) {
+    m_ltpSource = ltpSource;
+    if (m_dirty) return;
+    m_dirty = true;
+    s_dirtyInputs.append(this);
+}
+
 void NodeBase::updateData(NodeBase* ltpSource) {
     if (m_isOutput) {
         qCritical() << "Method updateData() is only available for input nodes.";
@@ -445,9 +509,11 @@ void NodeBase::updateData(NodeBase* ltpSource) {
             }
 
             if (isFirst) {
+                // shares the data of the output until it is modified (copy-on-write):
                 m_data = data;
                 isFirst = false;
             } else {
+                // HTP merge of multiple outputs detaches and creates an own matrix:
                 m_data.addHtp(data);
             }
         }
@@ -460,6 +526,7 @@ void NodeBase::updateData(NodeBase* ltpSource) {
             qWarning() << "Data of output is too small for this input node.";
             return;
         }
+        // shares the data of the output until it is modified (copy-on-write):
         m_data = data;
     }
 
@@ -267,6 +267,18 @@ public slots:
      * modified to notify the connected Nodes about the change (Output Node only)
      */
     void dataWasModifiedByBlock();
+    /**
+     * @brief beginBatch starts a batch of modifications, dataWasModifiedByBlock() will only
+     * notify the connected Nodes once when the outermost batch ends (Output Node only)
+     *
+     * Prefer to use a NodeBatch, HsvDataModifier or RgbDataModifier stack variable instead.
+     */
+    void beginBatch();
+    /**
+     * @brief endBatch ends a batch started by beginBatch() and notifies the connected Nodes
+     * if the data was modified during the batch (Output Node only)
+     */
+    void endBatch();
     /**
      * @brief sendImpulse sets the output for ~1/10s to 1.0 and then back to 0.0
      */
@@ -281,8 +293,8 @@ public slots:
      */
     void setHsv(double h, double s, double v);
     /**
-     * @brief setHsvAt convenience method to set a color at a certain position by HSV values
-     * (Output Node only)
+     * @brief setHsvAt convenience method to set a color at a certain position by HSV values,
+     * use it inside of a NodeBatch when setting multiple pixels (Output Node only)
      * @param x position
      * @param y position
      * @param h hue between 0 and 1
@@ -298,8 +310,8 @@ public slots:
      */
     void setRgb(double r, double g, double b);
     /**
-     * @brief setRgbAt convenience method to set a color at a certain position by RGB values
-     * (Output Node only)
+     * @brief setRgbAt convenience method to set a color at a certain position by RGB values,
+     * use it inside of a NodeBatch when setting multiple pixels (Output Node only)
      * @param x position
      * @param y position
      * @param r red between 0 and 1
@@ -325,6 +337,48 @@ public slots:
      */
     void addNodeSharingRequestedSize(NodeBase* input);
 
+    // ------------------------ Deferred Evaluation --------------------------
+    /**
+     * @brief deferredPropagationEnabled returns if changed data is only marked as dirty
+     * and evaluated once per frame by the BlockManager instead of being pushed immediately
+     * @return true if deferred propagation is enabled
+     */
+    static bool deferredPropagationEnabled() { return s_deferredPropagation; }
+    /**
+     * @brief setDeferredPropagation enables or disables deferred propagation for all nodes
+     * (use BlockManager::setDeferredEvaluation() to make sure no dirty node is left)
+     * @param value true to enable deferred propagation
+     */
+    static void setDeferredPropagation(bool value) { s_deferredPropagation = value; }
+    /**
+     * @brief topologyVersion returns a number that changes every time two nodes are
+     * connected or disconnected
+     * @return a version number
+     */
+    static quint64 topologyVersion() { return s_topologyVersion; }
+    /**
+     * @brief takeDirtyInputs returns all input nodes that were marked as dirty since the last call
+     * @return a list of input nodes
+     */
+    static QVector<QPointer<NodeBase>> takeDirtyInputs();
+    /**
+     * @brief getDownstreamBlocks returns the blocks that are connected to the outputs of a block
+     * (a block is contained once for each connection)
+     * @param block the block to start from
+     * @return a list of blocks
+     */
+    static QVector<BlockInterface*> getDownstreamBlocks(BlockInterface* block);
+    /**
+     * @brief isDirty returns if the data of this node has to be updated (Input Node only)
+     * @return true if the node is dirty
+     */
+    bool isDirty() const { return m_dirty; }
+    /**
+     * @brief updateIfDirty merges the data of the connected outputs if this node is dirty
+     * (Input Node only)
+     */
+    void updateIfDirty();
+
 private slots:
     /**
      * @brief checkForImpulse emits impulse signals, is calles on value change if impulse mode is active
@@ -340,9 +394,15 @@ protected:
 
     bool cycleCheck(NodeBase* outputNode, NodeBase* inputNode);
 
-    bool cycleCheckRecursive(QString uid, NodeBase* inputNode, int depth);
+    bool cycleCheckRecursive(QString uid, BlockInterface* block, int depth);
 
     // ------------------------ internal logic of Input Node:
+    /**
+     * @brief markDirty is called instead of updateData() if deferred propagation is enabled
+     * @param ltpSource a pointer to the Node thats data was changed last (for LTP merging)
+     */
+    void markDirty(NodeBase* ltpSource);
+
     /**
      * @brief updateData is called to notify the Node that the data of a connected output changed;
      * it merges the data of all connected nodes and emits dataChanged(); (Input Node only)
@@ -380,6 +440,10 @@ protected:
     bool m_isActive;  //!< true if this Node is in active state
     bool m_htp;  //!< true if this Node uses HTP merging, false if LTP
     bool m_impulseActive;  //!< true if value is above threshold and impulseBegin was sent (only in impulse mode)
+    bool m_dirty;  //!< true if data of a connected output changed and this node wasn't updated yet
+    int m_batchDepth;  //!< number of nested batches currently open
+    bool m_modifiedInBatch;  //!< true if dataWasModifiedByBlock() was called during the current batch
+    QPointer<NodeBase> m_ltpSource;  //!< the output that changed last while this node was dirty
     QTimer m_impulseTimer;  //!< used for sendImpulse() to set the value back to 0.0 after a short time
 
     // data:
@@ -388,51 +452,101 @@ protected:
 
     // static infos:
     static QPointer<NodeBase> s_focusedNode;  //!< contains a pointer to the focused Node or nullptr
+    static bool s_deferredPropagation;  //!< true if changes are evaluated once per frame
+    static quint64 s_topologyVersion;  //!< changes every time nodes are connected or disconnected
+    static QVector<QPointer<NodeBase>> s_dirtyInputs;  //!< input nodes marked as dirty
+};
+
+
+/**
+ * @brief An object of the NodeBatch class groups all modifications of an output node
+ * during its lifetime, the connected nodes are notified only once at the end.
+ * It should only be used as a stack variable.
+ */
+class NodeBatch {
+
+public:
+    explicit NodeBatch(NodeBase* node)
+        : m_node(node)
+    {
+        m_node->beginBatch();
+    }
+
+    NodeBatch(NodeBatch&& other)
+        : m_node(other.m_node)
+    {
+        other.m_node = nullptr;
+    }
+
+    NodeBatch(const NodeBatch&) = delete;
+    NodeBatch& operator=(const NodeBatch&) = delete;
+
+    ~NodeBatch() {
+        if (m_node) m_node->endBatch();
+    }
+
+    /**
+     * @brief markModified marks the data of the node as modified,
+     * the connected nodes will be notified at the end of the batch
+     */
+    void markModified() {
+        if (m_node) m_node->dataWasModifiedByBlock();
+    }
+
+protected:
+    NodeBase* m_node;
 };
 
 
 /**
  * @brief An object of the HsvDataModifier struct can be used to modify the HSV data of
  * an output node.
+ * The connected nodes are notified once at the end of its lifetime (or at the end of an
+ * enclosing NodeBatch).
  * Attention: It should only be used as a stack variable because during the lifetime of this modifier object
  * the data in the output node is not consistent!
  */
 struct HsvDataModifier {
 
     explicit HsvDataModifier(NodeBase* node)
-        : m_node(node)
-        , m_matrix(node->data())
-        , width(m_matrix.width())
-        , height(m_matrix.height())
+        : m_batch(node)
+        , m_matrix(detached(node->data()))
+        , width(m_matrix.width)
+        , height(m_matrix.height)
     {
-        m_matrix.m_hsvIsValid = true;
-        m_matrix.m_rgbIsValid = false;
-        m_matrix.m_valueIsValid = false;
+        m_matrix.hsvIsValid = true;
+        m_matrix.rgbIsValid = false;
+        m_matrix.valueIsValid = false;
+        m_batch.markModified();
     }
 
-    ~HsvDataModifier() {
-        m_node->dataWasModifiedByBlock();
-    }
+    HsvDataModifier(HsvDataModifier&&) = default;
 
     void set(int x, int y, double h, double s, double v) {
-        m_matrix.m_hsvData.at(x, y) = HSV(h, s, v);
+        m_matrix.hsvData.at(x, y) = HSV(h, s, v);
     }
 
     void set(int x, int y, const HSV& val) {
-        m_matrix.m_hsvData.at(x, y) = val;
+        m_matrix.hsvData.at(x, y) = val;
     }
 
     HSV get(int x, int y) const {
-        return m_matrix.m_hsvData.at(x, y);
+        return m_matrix.hsvData.at(x, y);
     }
 
     void setFrom(const HsvMatrix& matrix) {
-        m_matrix.m_hsvData.setFrom(matrix);
+        m_matrix.hsvData.setFrom(matrix);
     }
 
 protected:
-    NodeBase* const m_node;
-    ColorMatrix& m_matrix;
+    static ColorMatrixData& detached(ColorMatrix& matrix) {
+        // the data may be shared with input nodes, get an own copy before modifying it:
+        matrix.d.detach();
+        return *matrix.d;
+    }
+
+    NodeBatch m_batch;
+    ColorMatrixData& m_matrix;
 
 public:
     const int width;
@@ -443,41 +557,48 @@ public:
 /**
  * @brief An object of the RgbDataModifier struct can be used to modify the RGB data of
  * an output node.
+ * The connected nodes are notified once at the end of its lifetime (or at the end of an
+ * enclosing NodeBatch).
  * Attention: It should only be used as a stack variable because during the lifetime of this modifier object
  * the data in the output node is not consistent!
  */
 struct RgbDataModifier {
 
     explicit RgbDataModifier(NodeBase* node)
-        : m_node(node)
-        , m_matrix(node->data())
-        , width(m_matrix.width())
-        , height(m_matrix.height())
+        : m_batch(node)
+        , m_matrix(detached(node->data()))
+        , width(m_matrix.width)
+        , height(m_matrix.height)
     {
-        m_matrix.m_hsvIsValid = false;
-        m_matrix.m_rgbIsValid = true;
-        m_matrix.m_valueIsValid = false;
+        m_matrix.hsvIsValid = false;
+        m_matrix.rgbIsValid = true;
+        m_matrix.valueIsValid = false;
+        m_batch.markModified();
     }
 
-    ~RgbDataModifier() {
-        m_node->dataWasModifiedByBlock();
-    }
+    RgbDataModifier(RgbDataModifier&&) = default;
 
     void set(int x, int y, double r, double g, double b) {
-        m_matrix.m_rgbData.at(x, y) = RGB(r, g, b);
+        m_matrix.rgbData.at(x, y) = RGB(r, g, b);
     }
 
     void set(int x, int y, const RGB& val) {
-        m_matrix.m_rgbData.at(x, y) = val;
+        m_matrix.rgbData.at(x, y) = val;
     }
 
     RGB get(int x, int y) const {
-        return m_matrix.m_rgbData.at(x, y);
+        return m_matrix.rgbData.at(x, y);
     }
 
 protected:
-    NodeBase* const m_node;
-    ColorMatrix& m_matrix;
+    static ColorMatrixData& detached(ColorMatrix& matrix) {
+        // the data may be shared with input nodes, get an own copy before modifying it:
+        matrix.d.detach();
+        return *matrix.d;
+    }
+
+    NodeBatch m_batch;
+    ColorMatrixData& m_matrix;
 
 public:
     const int width;
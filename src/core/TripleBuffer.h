@@ -0,0 +1,102 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+
+/**
+ * @brief The TripleBuffer class hands the latest version of a value from one producer thread
+ * to one consumer thread without locks.
+ *
+ * The producer writes into writeBuffer() and calls publish(), the consumer calls update() and
+ * reads readBuffer(). Neither side ever waits for the other, intermediate versions are skipped
+ * if the consumer is slower than the producer.
+ */
+template<typename T>
+class TripleBuffer {
+
+public:
+    TripleBuffer()
+        : m_writeIndex(0)
+        , m_readIndex(1)
+        , m_shared(2)
+    {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // ---- Producer side:
+
+    /**
+     * @brief writeBuffer returns the buffer that is owned by the producer (producer only)
+     * @return a reference to the buffer to write to
+     */
+    T& writeBuffer() { return m_buffers[m_writeIndex]; }
+
+    /**
+     * @brief publish makes the content of writeBuffer() available to the consumer;
+     * writeBuffer() refers to a different (possibly outdated) buffer afterwards (producer only)
+     */
+    void publish() {
+        const int previous = m_shared.exchange(m_writeIndex | s_newDataFlag, std::memory_order_acq_rel);
+        m_writeIndex = previous & s_indexMask;
+    }
+
+    // ---- Consumer side:
+
+    /**
+     * @brief update fetches the last published buffer if there is one (consumer only)
+     * @return true if readBuffer() changed
+     */
+    bool update() {
+        if (!(m_shared.load(std::memory_order_acquire) & s_newDataFlag)) return false;
+        const int previous = m_shared.exchange(m_readIndex, std::memory_order_acq_rel);
+        m_readIndex = previous & s_indexMask;
+        return true;
+    }
+
+    /**
+     * @brief readBuffer returns the buffer that is owned by the consumer (consumer only)
+     * @return a const reference to the last fetched buffer
+     */
+    const T& readBuffer() const { return m_buffers[m_readIndex]; }
+
+    /**
+     * @brief latest is a convenience method that calls update() and returns readBuffer()
+     * (consumer only)
+     * @return a const reference to the latest published buffer
+     */
+    const T& latest() { update(); return readBuffer(); }
+
+protected:
+    static const int s_indexMask = 0x3;
+    static const int s_newDataFlag = 0x4;
+
+    T m_buffers[3];
+    int m_writeIndex;  //!< index of the buffer owned by the producer
+    int m_readIndex;  //!< index of the buffer owned by the consumer
+    std::atomic<int> m_shared;  //!< index of the buffer in between and the "new data" flag
+};
+
+#endif // TRIPLEBUFFER_H
@@ -6,7 +6,7 @@
 FixtureBlock::FixtureBlock(MainController *controller, QString uid, int footprint)
     : InOutBlock(controller, uid)
     , m_footprint(footprint)
-    , m_address(this, "address", 1, 1, 8193 - m_footprint)
+    , m_address(this, "address", 1, 1, OutputManagerConstants::maxAddress + 1 - m_footprint)
     , m_gamma(this, "gamma", 1.0, 0.1, 10.0)
 {
     m_isSceneBlock = true;
@@ -3,11 +3,15 @@
 #include "core/MainController.h"
 #include "core/Nodes.h"
 #include "core/SmartAttribute.h"
+#include "core/manager/FrameProfiler.h"
 #include "block_implementations/Luminosus/GroupBlock.h"
 
 #include <QQmlEngine>
 #include <QQuickItem>
 #include <QQuickWindow>
+#include <QSet>
+#include <functional>
+#include <queue>
 
 
 BlockManager::BlockManager(MainController* controller)
@@ -20,8 +24,10 @@ BlockManager::BlockManager(MainController* controller)
     , m_startChannel(1)
 	, m_lastDeletedBlockStates(BlockManagerConstants::undoHistoryLength)
     , m_hideBlocksOutsideViewports(true)
+    , m_topologyVersion(0)
 {
     m_randomConnectionTimer.setInterval(100);
+    connect(controller->engine(), SIGNAL(evaluateNodes()), this, SLOT(evaluateNodeGraph()));
     connect(&m_randomConnectionTimer, SIGNAL(timeout()), this, SLOT(makeRandomConnection()));
 	// Register classes which slots should be accessible from QML:
 	qmlRegisterType<BlockList>();
@@ -628,3 +634,102 @@ BlockInterface* BlockManager::createBlockInstance(QString blockType, QString uid
 	// return a pointer to the block instance:
 	return block;
 }
+
+bool BlockManager::getDeferredEvaluation() const {
+    return NodeBase::deferredPropagationEnabled();
+}
+
+void BlockManager::setDeferredEvaluation(bool value) {
+    if (value == NodeBase::deferredPropagationEnabled()) return;
+    // evaluate all remaining dirty nodes before switching the mode:
+    evaluateNodeGraph();
+    NodeBase::setDeferredPropagation(value);
+    emit deferredEvaluationChanged();
+}
+
+void BlockManager::evaluateNodeGraph() {
+    QVector<QPointer<NodeBase>> dirtyInputs = NodeBase::takeDirtyInputs();
+    if (dirtyInputs.isEmpty()) return;
+
+    if (m_topologyVersion != NodeBase::topologyVersion()) {
+        updateTopologicalOrder();
+    }
+
+    // blocks with dirty inputs ordered by their topological rank (lowest first):
+    typedef QPair<int, BlockInterface*> RankedBlock;
+    std::priority_queue<RankedBlock, std::vector<RankedBlock>, std::greater<RankedBlock>> queue;
+    QSet<BlockInterface*> queuedBlocks;
+    QSet<BlockInterface*> evaluatedBlocks;
+
+    auto enqueue = [&](const QVector<QPointer<NodeBase>>& nodes) {
+        for (NodeBase* node: nodes) {
+            if (!node) continue;
+            BlockInterface* block = node->getBlock();
+            if (!block) continue;
+            if (evaluatedBlocks.contains(block)) {
+                // block was already evaluated in this frame (can only happen if the topological
+                // order is outdated) -> update the node immediately:
+                ProfilerScope profilerScope(block, FrameProfiler::DataCascade);
+                node->updateIfDirty();
+                continue;
+            }
+            if (queuedBlocks.contains(block)) continue;
+            queuedBlocks.insert(block);
+            queue.push(RankedBlock(m_topologicalRank.value(block, m_topologicalRank.size()), block));
+        }
+    };
+
+    enqueue(dirtyInputs);
+    while (!queue.empty()) {
+        // evaluate the block with the lowest rank, all blocks before it are already up to date:
+        BlockInterface* block = queue.top().second;
+        queue.pop();
+        evaluatedBlocks.insert(block);
+        {
+            // measured like the cascade in NodeBase::dataWasModifiedByBlock() without deferred evaluation:
+            ProfilerScope profilerScope(block, FrameProfiler::DataCascade);
+            for (NodeBase* node: block->getNodes()) {
+                if (!node || node->isOutput()) continue;
+                node->updateIfDirty();
+            }
+        }
+        // the updated block may have marked the inputs of downstream blocks as dirty:
+        enqueue(NodeBase::takeDirtyInputs());
+    }
+}
+
+void BlockManager::updateTopologicalOrder() {
+    // Kahn's algorithm:
+    m_topologicalRank.clear();
+    QHash<BlockInterface*, int> inDegree;
+    for (BlockInterface* block: m_currentBlocks) {
+        if (!block) continue;
+        inDegree.insert(block, 0);
+    }
+    for (BlockInterface* block: m_currentBlocks) {
+        if (!block) continue;
+        for (BlockInterface* nextBlock: NodeBase::getDownstreamBlocks(block)) {
+            ++inDegree[nextBlock];
+        }
+    }
+
+    QVector<BlockInterface*> ready;
+    for (auto it = inDegree.constBegin(); it != inDegree.constEnd(); ++it) {
+        if (it.value() == 0) ready.append(it.key());
+    }
+    int rank = 0;
+    while (!ready.isEmpty()) {
+        BlockInterface* block = ready.takeLast();
+        m_topologicalRank.insert(block, rank++);
+        for (BlockInterface* nextBlock: NodeBase::getDownstreamBlocks(block)) {
+            if (--inDegree[nextBlock] == 0) {
+                ready.append(nextBlock);
+            }
+        }
+    }
+    if (rank < inDegree.size()) {
+        // should not happen because cycles are prevented when connecting nodes:
+        qWarning() << "Node graph contains a cycle, it can't be ordered topologically.";
+    }
+    m_topologyVersion = NodeBase::topologyVersion();
+}
@@ -7,6 +7,7 @@
 
 #include <QObject>
 #include <QPointer>
+#include <QHash>
 #include <vector>
 #include <QTimer>
 #include <QSoundEffect>
@@ -45,6 +46,7 @@ class BlockManager : public QObject
 
     Q_PROPERTY(QString displayedGroup READ getDisplayedGroup NOTIFY displayedGroupChanged)
     Q_PROPERTY(QString displayedGroupLabel READ getDisplayedGroupLabel NOTIFY displayedGroupChanged)
+    Q_PROPERTY(bool deferredEvaluation READ getDeferredEvaluation WRITE setDeferredEvaluation NOTIFY deferredEvaluationChanged)
 
     friend class BlockBase;
 
@@ -232,6 +234,22 @@ public slots:
 	 */
     BlockInterface* getFocusedBlock() const { return m_focusedBlock; }
 
+    // ----------------- Node Graph Evaluation:
+
+    bool getDeferredEvaluation() const;
+    /**
+     * @brief setDeferredEvaluation enables or disables the evaluation of changed node data once
+     * per frame in topological order (instead of pushing each change immediately)
+     * @param value true to enable deferred evaluation
+     */
+    void setDeferredEvaluation(bool value);
+
+    /**
+     * @brief evaluateNodeGraph updates all dirty input nodes once in topological order of their blocks,
+     * called by the engine each frame
+     */
+    void evaluateNodeGraph();
+
     // ----------------- Smoke Tests:
 
     void startRandomConnectionTest();
@@ -261,6 +279,8 @@ signals:
 
     void displayedGroupChanged();
 
+    void deferredEvaluationChanged();
+
 private:
 	/**
 	 * @brief createBlockInstance creates a block instance and adds it to the correct lists
@@ -282,6 +302,12 @@ private:
 	 */
 	QPoint getBlockListPosition() const;
 
+    /**
+     * @brief updateTopologicalOrder calculates the topological rank of all blocks
+     * (a block is always ranked after all blocks connected to its inputs)
+     */
+    void updateTopologicalOrder();
+
 
 protected:
 	/**
@@ -342,6 +368,15 @@ protected:
      */
     QTimer m_randomConnectionTimer;
 
+    /**
+     * @brief m_topologicalRank maps each block to its position in the topological order
+     */
+    QHash<BlockInterface*, int> m_topologicalRank;
+    /**
+     * @brief m_topologyVersion is the NodeBase::topologyVersion() m_topologicalRank was calculated for
+     */
+    quint64 m_topologyVersion;
+
     QSoundEffect m_clickSound;
     QSoundEffect m_clickUpSound;
 };
@@ -18,31 +18,203 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+
 #include "Engine.h"
 
+#include <QDebug>
+#include <thread>
+
+
+// ------------------------ FrameClockThread ---------------------------
+
+FrameClockThread::FrameClockThread(QObject* parent)
+    : QThread(parent)
+    , m_fps(50)
+    , m_stopRequested(false)
+{
+
+}
+
+void FrameClockThread::run() {
+    using clock = std::chrono::steady_clock;
+    m_stopRequested = false;
+
+    clock::time_point deadline = clock::now();
+    clock::time_point lastFrameTime = deadline;
+    EngineClockStats stats;
+
+    while (!m_stopRequested) {
+        const clock::duration period = std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>(1.0 / m_fps));
+        // next deadline is based on the last deadline, not on the actual time -> no drift:
+        deadline += period;
+        std::this_thread::sleep_until(deadline);
+        if (m_stopRequested) break;
+
+        const clock::time_point now = clock::now();
+        const clock::duration lateness = now - deadline;
+        stats.lastLateness = std::chrono::duration<double>(lateness).count();
+        if (lateness > period) {
+            // more than a whole frame behind -> resynchronize instead of catching up with a burst:
+            ++stats.lateFrameCount;
+            deadline = now;
+        }
+        ++stats.frameCount;
+        m_stats.writeBuffer() = stats;
+        m_stats.publish();
+
+        const double timeSinceLastFrame = std::chrono::duration<double>(now - lastFrameTime).count();
+        lastFrameTime = now;
+        emit frameDue(timeSinceLastFrame);
+    }
+}
+
+
+// ------------------------ Engine ---------------------------
 
 Engine::Engine(QObject* parent, int fps)
 	: QObject(parent)
 	, m_timer(this)
-	, m_fps(fps)
+    , m_clock(this)
+    , m_profiler(this)
+	, m_fps(limit(EngineConstants::minFps, fps, EngineConstants::maxFps))
+    , m_realtimeMode(false)
+    , m_running(false)
+    , m_blockTickPending(false)
+    , m_skippedBlockFrames(0)
+    , m_clockStatsTimer(this)
+    , m_clockStats()
 {
 	m_lastFrameTime = HighResTime::now();
-	connect(&m_timer, SIGNAL(timeout()), this, SLOT(tick()));
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(onTimerTimeout()));
+    m_clock.setFps(m_fps);
+    connect(&m_clock, SIGNAL(frameDue(double)), this, SLOT(onClockFrame(double)), Qt::DirectConnection);
+    m_clockStatsTimer.setInterval(EngineConstants::clockStatsInterval);
+    connect(&m_clockStatsTimer, SIGNAL(timeout()), this, SLOT(updateClockStats()));
+}
+
+Engine::~Engine() {
+    stop();
+}
+
+QJsonObject Engine::getState() const {
+    QJsonObject state;
+    state["fps"] = getFps();
+    state["realtimeMode"] = getRealtimeMode();
+    return state;
+}
+
+void Engine::setState(const QJsonObject& state) {
+    if (state.isEmpty()) return;
+    if (state["fps"].toInt() > 0) {
+        setFps(state["fps"].toInt());
+    }
+    setRealtimeMode(state["realtimeMode"].toBool());
 }
 
 void Engine::start() {
-    m_timer.start(1000 / m_fps);
+    if (m_running) return;
+    m_running = true;
+    m_lastFrameTime = HighResTime::now();
+    if (m_realtimeMode) {
+        m_blockTickPending = false;
+        m_clock.start(QThread::TimeCriticalPriority);
+        m_clockStatsTimer.start();
+    } else {
+        m_nextDeadline = std::chrono::steady_clock::now();
+        scheduleNextTimerTick();
+    }
 }
 
 void Engine::stop() {
+    m_running = false;
     m_timer.stop();
+    m_clockStatsTimer.stop();
+    if (m_clock.isRunning()) {
+        m_clock.requestStop();
+        m_clock.wait();
+    }
+}
+
+void Engine::setFps(int value) {
+    value = limit(EngineConstants::minFps, value, EngineConstants::maxFps);
+    if (value == m_fps) return;
+    m_fps = value;
+    m_clock.setFps(m_fps);
+    emit fpsChanged();
+}
+
+void Engine::setRealtimeMode(bool value) {
+    if (value == m_realtimeMode) return;
+    const bool wasRunning = m_running;
+    stop();
+    m_realtimeMode = value;
+    if (wasRunning) start();
+    emit realtimeModeChanged();
+}
+
+void Engine::updateClockStats() {
+    // this is the only consumer of the published stats:
+    m_clockStats = m_clock.stats();
+    emit clockStatsChanged();
 }
 
 void Engine::tick() {
     // calculate time once last frame:
     const double timeSinceLastFrame = HighResTime::getElapsedSecAndUpdate(m_lastFrameTime);
 
+    m_profiler.beginFrame(timeSinceLastFrame, 1.0 / m_fps);
+
 	// call signals in logical order:
 	emit updateBlocks(timeSinceLastFrame);
+	emit evaluateNodes();
+    m_profiler.beginOutputStage();
 	emit updateOutput(timeSinceLastFrame);
+
+    m_profiler.endFrame();
+}
+
+void Engine::onTimerTimeout() {
+    tick();
+    if (m_running && !m_realtimeMode) {
+        scheduleNextTimerTick();
+    }
+}
+
+void Engine::onClockFrame(double timeSinceLastFrame) {
+    // this is called in the engine thread:
+    emit outputFrameDue(timeSinceLastFrame);
+
+    // queue at most one tick to the main thread, skip frames while it is busy:
+    if (m_blockTickPending.exchange(true)) {
+        ++m_skippedBlockFrames;
+        return;
+    }
+    QMetaObject::invokeMethod(this, "onQueuedTick", Qt::QueuedConnection);
+}
+
+void Engine::onQueuedTick() {
+    m_blockTickPending = false;
+    if (!m_running) return;
+    tick();
+}
+
+void Engine::scheduleNextTimerTick() {
+    using namespace std::chrono;
+    const steady_clock::time_point now = steady_clock::now();
+    // next deadline is based on the last deadline, not on the actual time -> no drift:
+    m_nextDeadline += period();
+    if (m_nextDeadline < now) {
+        // more than a whole frame behind -> resynchronize:
+        m_nextDeadline = now + period();
+    }
+    const int remainingMs = int(duration_cast<milliseconds>(m_nextDeadline - now).count());
+    m_timer.start(qMax(0, remainingMs));
+}
+
+std::chrono::steady_clock::duration Engine::period() const {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / m_fps));
 }
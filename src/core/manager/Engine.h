@@ -18,27 +18,124 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+
 #ifndef ENGINE_H
 #define ENGINE_H
 
+#include "core/manager/FrameProfiler.h"
+#include "core/TripleBuffer.h"
 #include "utils.h"
 
 #include <QObject>
 #include <QTimer>
+#include <QThread>
+#include <QJsonObject>
+#include <atomic>
 #include <chrono>
 
 
+/**
+ * @brief The EngineConstants namespace contains all constants used in Engine.
+ */
+namespace EngineConstants {
+    /**
+     * @brief minFps is the lowest frame rate the engine can be configured to
+     */
+    static const int minFps = 30;
+    /**
+     * @brief maxFps is the highest frame rate the engine can be configured to
+     */
+    static const int maxFps = 240;
+    /**
+     * @brief clockStatsInterval is the interval the clock statistics are updated in the GUI in ms
+     */
+    static const int clockStatsInterval = 500;
+}
+
+
+/**
+ * @brief The EngineClockStats struct is the timing information published by the FrameClockThread.
+ */
+struct EngineClockStats {
+    EngineClockStats() : frameCount(0), lateFrameCount(0), lastLateness(0.0) {}
+
+    quint64 frameCount;  //!< number of frames generated since start
+    quint64 lateFrameCount;  //!< number of frames that were more than a whole period late
+    double lastLateness;  //!< time in seconds the last frame was behind its deadline
+};
+
+
+/**
+ * @brief The FrameClockThread class generates frames at absolute deadlines in its own thread.
+ *
+ * The deadlines are calculated from the start time and not from the time of the last frame,
+ * so that delays do not accumulate (no drift). If it falls behind more than a whole frame
+ * (i.e. after a system suspend) it resynchronizes instead of generating a burst of frames.
+ */
+class FrameClockThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit FrameClockThread(QObject* parent = nullptr);
+
+    /**
+     * @brief setFps changes the frame rate, can be called while the thread is running
+     * @param fps frames per second
+     */
+    void setFps(int fps) { m_fps = fps; }
+
+    /**
+     * @brief requestStop lets the thread finish after the current frame
+     */
+    void requestStop() { m_stopRequested = true; }
+
+    /**
+     * @brief stats returns the latest published timing information (to be called from one thread only)
+     * @return timing information
+     */
+    const EngineClockStats& stats() { return m_stats.latest(); }
+
+signals:
+    /**
+     * @brief frameDue is emitted in the clock thread every time a frame deadline is reached
+     * @param timeSinceLastFrame is the time in seconds since the last frame
+     */
+    void frameDue(double timeSinceLastFrame);
+
+protected:
+    void run() override;
+
+    std::atomic<int> m_fps;  //!< frames per second
+    std::atomic<bool> m_stopRequested;  //!< true if the thread should exit
+    TripleBuffer<EngineClockStats> m_stats;  //!< timing information, written by the clock thread
+};
+
+
 /**
  * @brief The Engine class defines an engine that is responsible to trigger all non-GUI actions
  * that have to be done regulary (i.e. block logic and data output).
  * It generates different signals with a specified FPS rate.
  *
  * It is independent from the GUI. Actions that affect the GUI should be triggered by QTimer.
+ *
+ * In realtime mode the frames are generated by a FrameClockThread. The block logic is still
+ * executed in the main thread (because blocks are QObjects with GUI bindings), but a busy
+ * main thread only causes block frames to be skipped while outputFrameDue() is still emitted
+ * on time from the engine thread.
+ * The timing statistics of the engine thread are fetched periodically in the main thread
+ * and are available as properties.
  */
 class Engine : public QObject
 {
 	Q_OBJECT
 
+    Q_PROPERTY(int fps READ getFps WRITE setFps NOTIFY fpsChanged)
+    Q_PROPERTY(bool realtimeMode READ getRealtimeMode WRITE setRealtimeMode NOTIFY realtimeModeChanged)
+    Q_PROPERTY(double lateFrameCount READ getLateFrameCount NOTIFY clockStatsChanged)
+    Q_PROPERTY(double skippedBlockFrameCount READ getSkippedBlockFrameCount NOTIFY clockStatsChanged)
+    Q_PROPERTY(double lastLateness READ getLastLateness NOTIFY clockStatsChanged)
+
 public:
 	/**
 	 * @brief Engine creates an engine instance
@@ -47,18 +144,51 @@ public:
 	 */
     explicit Engine(QObject* parent = 0, int fps = 50);
 
+    ~Engine();
+
+    /**
+     * @brief getState returns the settings of the engine to persist them
+     * @return the settings as a QJsonObject
+     */
+    QJsonObject getState() const;
+
+    /**
+     * @brief setState restores the settings from a saved Json object
+     * @param state a QJsonObject previously generated by getState()
+     */
+    void setState(const QJsonObject& state);
+
 signals:
 	/**
 	 * @brief updateBlocks is emitted every frame when the block logic should update its values
 	 * @param timeSinceLastFrame is the time in seconds since the last call of this signal
 	 */
     void updateBlocks(double timeSinceLastFrame);
+    /**
+     * @brief evaluateNodes is emitted every frame after updateBlocks and before updateOutput,
+     * the node graph should evaluate all nodes marked as dirty in this frame
+     */
+    void evaluateNodes();
 	/**
 	 * @brief updateOutput is emitted every frame after the blocks have been updated
 	 * and the output (i.e. ArtNet, sACN) should be updated
 	 * @param timeSinceLastFrame is the time in seconds since the last call of this signal
 	 */
     void updateOutput(double timeSinceLastFrame);
+    /**
+     * @brief outputFrameDue is emitted every frame in realtime mode from the engine thread,
+     * even if the main thread is busy; only connect thread-safe slots with Qt::DirectConnection
+     * @param timeSinceLastFrame is the time in seconds since the last call of this signal
+     */
+    void outputFrameDue(double timeSinceLastFrame);
+
+    void fpsChanged();
+    void realtimeModeChanged();
+    /**
+     * @brief clockStatsChanged is emitted when the timing statistics of the engine thread
+     * were fetched (realtime mode only)
+     */
+    void clockStatsChanged();
 
 public slots:
 
@@ -72,6 +202,47 @@ public slots:
 	 */
     void stop();
 
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief profiler returns the FrameProfiler that measures the duration of each frame
+     * @return a pointer to the FrameProfiler
+     */
+    FrameProfiler* profiler() { return &m_profiler; }
+
+    int getFps() const { return m_fps; }
+    /**
+     * @brief setFps sets the frame rate
+     * @param value frames per second [EngineConstants::minFps...EngineConstants::maxFps]
+     */
+    void setFps(int value);
+
+    bool getRealtimeMode() const { return m_realtimeMode; }
+    /**
+     * @brief setRealtimeMode enables or disables the dedicated engine thread
+     * @param value true to generate frames in a separate thread
+     */
+    void setRealtimeMode(bool value);
+
+    /**
+     * @brief getLateFrameCount returns the number of frames that were generated more than
+     * a whole period too late by the engine thread (realtime mode only)
+     * @return number of late frames since start
+     */
+    double getLateFrameCount() const { return double(m_clockStats.lateFrameCount); }
+    /**
+     * @brief getSkippedBlockFrameCount returns the number of frames the block logic was skipped
+     * because the main thread was busy (realtime mode only)
+     * @return number of skipped frames since start
+     */
+    double getSkippedBlockFrameCount() const { return double(m_skippedBlockFrames); }
+    /**
+     * @brief getLastLateness returns how late the last frame of the engine thread was
+     * (realtime mode only)
+     * @return time in seconds
+     */
+    double getLastLateness() const { return m_clockStats.lastLateness; }
+
 private slots:
 
 	/**
@@ -80,19 +251,84 @@ private slots:
 	 */
 	void tick();
 
+    /**
+     * @brief onTimerTimeout is called by the timer in non-realtime mode, calls tick()
+     * and schedules the next frame
+     */
+    void onTimerTimeout();
+
+    /**
+     * @brief onClockFrame is called in the engine thread in realtime mode
+     * @param timeSinceLastFrame is the time in seconds since the last frame
+     */
+    void onClockFrame(double timeSinceLastFrame);
+
+    /**
+     * @brief onQueuedTick is called in the main thread in realtime mode
+     */
+    void onQueuedTick();
+
+    /**
+     * @brief updateClockStats fetches the timing statistics published by the engine thread
+     */
+    void updateClockStats();
+
 private:
+    /**
+     * @brief scheduleNextTimerTick advances the next deadline and starts the timer accordingly
+     */
+    void scheduleNextTimerTick();
+
+    std::chrono::steady_clock::duration period() const;
+
 	/**
 	 * @brief m_timer is the timer that triggers the tick() function
 	 */
 	QTimer m_timer;
+    /**
+     * @brief m_clock is the thread that generates the frames in realtime mode
+     */
+    FrameClockThread m_clock;
+    /**
+     * @brief m_profiler measures the duration of each frame if enabled
+     */
+    FrameProfiler m_profiler;
 	/**
 	 * @brief m_fps is the amount of frames per second to be generated
 	 */
 	int m_fps;
+    /**
+     * @brief m_realtimeMode is true if the frames are generated in a separate thread
+     */
+    bool m_realtimeMode;
+    /**
+     * @brief m_running is true between start() and stop()
+     */
+    bool m_running;
 	/**
 	 * @brief m_lastFrameTime is the time of the last generated frame
 	 */
 	HighResTime::time_point_t m_lastFrameTime;
+    /**
+     * @brief m_nextDeadline is the time the next frame is due in non-realtime mode
+     */
+    std::chrono::steady_clock::time_point m_nextDeadline;
+    /**
+     * @brief m_blockTickPending is true while a tick is queued to the main thread (realtime mode)
+     */
+    std::atomic<bool> m_blockTickPending;
+    /**
+     * @brief m_skippedBlockFrames counts the frames where the main thread was still busy (realtime mode)
+     */
+    std::atomic<quint64> m_skippedBlockFrames;
+    /**
+     * @brief m_clockStatsTimer triggers updateClockStats() in realtime mode
+     */
+    QTimer m_clockStatsTimer;
+    /**
+     * @brief m_clockStats is the last fetched timing information of the engine thread
+     */
+    EngineClockStats m_clockStats;
 
 };
 
@@ -0,0 +1,234 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "FrameProfiler.h"
+
+#include "core/block_data/BlockInterface.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QVariantMap>
+#include <QDebug>
+
+#include <algorithm>
+
+
+// initialize static member attributes:
+FrameProfiler* FrameProfiler::s_instance = nullptr;
+ProfilerScope* ProfilerScope::s_current = nullptr;
+
+
+// ------------------------ FrameProfiler ---------------------------
+
+FrameProfiler::FrameProfiler(QObject* parent)
+    : QObject(parent)
+    , m_enabled(false)
+    , m_frameActive(false)
+    , m_frameNumber(0)
+    , m_history(FrameProfilerConstants::historyLength)
+{
+    s_instance = this;
+}
+
+FrameProfiler::~FrameProfiler() {
+    if (s_instance == this) {
+        s_instance = nullptr;
+    }
+}
+
+void FrameProfiler::beginFrame(double timeSinceLastFrame, double targetPeriod) {
+    if (!m_enabled) return;
+    m_frameStart = clock::now();
+    m_outputStart = m_frameStart;
+    m_frameActive = true;
+    ++m_frameNumber;
+
+    m_currentFrame = ProfiledFrame();
+    m_currentFrame.frameNumber = m_frameNumber;
+    // the first frame after enabling has no meaningful previous frame:
+    m_currentFrame.jitter = m_history.size() ? timeSinceLastFrame - targetPeriod : 0.0;
+    m_currentBlockIndex.clear();
+}
+
+void FrameProfiler::beginOutputStage() {
+    if (!m_frameActive) return;
+    m_outputStart = clock::now();
+}
+
+void FrameProfiler::endFrame() {
+    if (!m_frameActive) return;
+    m_frameActive = false;
+    const clock::time_point now = clock::now();
+    m_currentFrame.tickDuration = std::chrono::duration<double>(now - m_frameStart).count();
+    m_currentFrame.blocksDuration = std::chrono::duration<double>(m_outputStart - m_frameStart).count();
+    m_currentFrame.outputDuration = std::chrono::duration<double>(now - m_outputStart).count();
+    m_history.append(m_currentFrame);
+    emit historyChanged();
+}
+
+void FrameProfiler::addBlockTime(BlockInterface* block, Category category, double seconds) {
+    // time outside of a frame (i.e. caused by user interaction) is not recorded:
+    if (!m_frameActive || !block) return;
+    const QString uid = block->getUid();
+    int index = m_currentBlockIndex.value(uid, -1);
+    if (index < 0) {
+        index = m_currentFrame.blocks.size();
+        m_currentBlockIndex.insert(uid, index);
+        ProfiledBlockTime blockTime;
+        blockTime.uid = uid;
+        m_currentFrame.blocks.append(blockTime);
+        if (!m_blockNames.contains(uid)) {
+            m_blockNames.insert(uid, block->getBlockName());
+        }
+    }
+    ProfiledBlockTime& blockTime = m_currentFrame.blocks[index];
+    if (category == BlockUpdate) {
+        blockTime.updateTime += seconds;
+    } else {
+        blockTime.cascadeTime += seconds;
+    }
+}
+
+void FrameProfiler::setEnabled(bool value) {
+    if (value == m_enabled) return;
+    m_enabled = value;
+    m_frameActive = false;
+    emit enabledChanged();
+}
+
+void FrameProfiler::clear() {
+    m_history.clear();
+    m_blockNames.clear();
+    emit historyChanged();
+}
+
+QVariantList FrameProfiler::getFrameHistory() const {
+    QVariantList frames;
+    for (int i = 0; i < m_history.size(); ++i) {
+        const ProfiledFrame& frame = m_history.at(i);
+        QVariantMap info;
+        info["frame"] = double(frame.frameNumber);
+        info["tick"] = frame.tickDuration * 1000;
+        info["jitter"] = frame.jitter * 1000;
+        info["blocks"] = frame.blocksDuration * 1000;
+        info["output"] = frame.outputDuration * 1000;
+        frames.append(info);
+    }
+    return frames;
+}
+
+QVariantList FrameProfiler::getBlockRanking(int count) const {
+    struct Sum {
+        Sum() : update(0), cascade(0), max(0) {}
+        double update;
+        double cascade;
+        double max;
+    };
+    QHash<QString, Sum> sums;
+    for (int i = 0; i < m_history.size(); ++i) {
+        for (const ProfiledBlockTime& blockTime: m_history.at(i).blocks) {
+            Sum& sum = sums[blockTime.uid];
+            sum.update += blockTime.updateTime;
+            sum.cascade += blockTime.cascadeTime;
+            sum.max = std::max(sum.max, blockTime.updateTime + blockTime.cascadeTime);
+        }
+    }
+
+    QVector<QPair<double, QString>> order;
+    for (auto it = sums.constBegin(); it != sums.constEnd(); ++it) {
+        order.append(qMakePair(it.value().update + it.value().cascade, it.key()));
+    }
+    std::sort(order.begin(), order.end(), [](const QPair<double, QString>& a, const QPair<double, QString>& b) {
+        return a.first > b.first;
+    });
+
+    QVariantList ranking;
+    const double frames = qMax(1, m_history.size());
+    for (int i = 0; i < order.size() && i < count; ++i) {
+        const Sum& sum = sums[order[i].second];
+        QVariantMap info;
+        info["uid"] = order[i].second;
+        info["name"] = m_blockNames.value(order[i].second);
+        info["update"] = sum.update / frames * 1000;
+        info["cascade"] = sum.cascade / frames * 1000;
+        info["total"] = order[i].first / frames * 1000;
+        info["max"] = sum.max * 1000;
+        ranking.append(info);
+    }
+    return ranking;
+}
+
+double FrameProfiler::getAverageTickDuration() const {
+    if (m_history.size() == 0) return 0.0;
+    double sum = 0.0;
+    for (int i = 0; i < m_history.size(); ++i) {
+        sum += m_history.at(i).tickDuration;
+    }
+    return sum / m_history.size() * 1000;
+}
+
+double FrameProfiler::getMaxJitter() const {
+    double maxJitter = 0.0;
+    for (int i = 0; i < m_history.size(); ++i) {
+        maxJitter = std::max(maxJitter, std::abs(m_history.at(i).jitter));
+    }
+    return maxJitter * 1000;
+}
+
+bool FrameProfiler::dumpToFile(QString filename) const {
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "Could not open file to write frame profile:" << filename;
+        return false;
+    }
+    QTextStream out(&file);
+    out << "frame,tick_ms,jitter_ms,blocks_ms,output_ms\n";
+    for (int i = 0; i < m_history.size(); ++i) {
+        const ProfiledFrame& frame = m_history.at(i);
+        out << frame.frameNumber << "," << frame.tickDuration * 1000 << "," << frame.jitter * 1000
+            << "," << frame.blocksDuration * 1000 << "," << frame.outputDuration * 1000 << "\n";
+    }
+    out << "\nframe,block_uid,block_name,update_ms,cascade_ms\n";
+    for (int i = 0; i < m_history.size(); ++i) {
+        const ProfiledFrame& frame = m_history.at(i);
+        for (const ProfiledBlockTime& blockTime: frame.blocks) {
+            out << frame.frameNumber << "," << blockTime.uid << "," << m_blockNames.value(blockTime.uid)
+                << "," << blockTime.updateTime * 1000 << "," << blockTime.cascadeTime * 1000 << "\n";
+        }
+    }
+    return true;
+}
+
+
+// ------------------------ ProfilerScope ---------------------------
+
+ProfilerScope::~ProfilerScope() {
+    if (!m_block) return;
+    const double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    s_current = m_parent;
+    if (m_parent) {
+        m_parent->m_childTime += total;
+    }
+    FrameProfiler* profiler = FrameProfiler::instance();
+    if (profiler) {
+        profiler->addBlockTime(m_block, m_category, total - m_childTime);
+    }
+}
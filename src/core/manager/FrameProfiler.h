@@ -0,0 +1,243 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include "core/QCircularBuffer.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QVector>
+#include <QVariantList>
+#include <chrono>
+
+// forward declaration:
+class BlockInterface;
+
+
+/**
+ * @brief The FrameProfilerConstants namespace contains all constants used in FrameProfiler.
+ */
+namespace FrameProfilerConstants {
+    /**
+     * @brief historyLength is the number of frames kept in the ring buffer
+     */
+    static const int historyLength = 500;
+}
+
+
+/**
+ * @brief The ProfiledBlockTime struct contains the time a block consumed in a single frame.
+ */
+struct ProfiledBlockTime {
+    ProfiledBlockTime() : updateTime(0.0), cascadeTime(0.0) {}
+
+    QString uid;  //!< UID of the block
+    double updateTime;  //!< time in seconds spent in the per-frame slot of the block
+    double cascadeTime;  //!< time in seconds spent propagating data from the outputs of the block
+};
+
+
+/**
+ * @brief The ProfiledFrame struct contains the timing information of a single engine frame.
+ */
+struct ProfiledFrame {
+    ProfiledFrame() : frameNumber(0), tickDuration(0.0), jitter(0.0), blocksDuration(0.0), outputDuration(0.0) {}
+
+    quint64 frameNumber;  //!< continuous number of this frame
+    double tickDuration;  //!< time in seconds Engine::tick() took
+    double jitter;  //!< difference in seconds between the actual and the target frame period
+    double blocksDuration;  //!< time in seconds spent handling Engine::updateBlocks()
+    double outputDuration;  //!< time in seconds spent handling Engine::updateOutput()
+    QVector<ProfiledBlockTime> blocks;  //!< time spent in each block that did something in this frame
+};
+
+
+/**
+ * @brief The FrameProfiler class records the duration of each engine frame and the time each
+ * block spends in its per-frame slot and in dataChanged cascades.
+ *
+ * The last frames are kept in a ring buffer that can be read from QML or dumped to a CSV file.
+ * Block times are exclusive, the time of nested scopes (i.e. a cascade triggered by a per-frame slot)
+ * is only attributed to the inner scope.
+ * Profiling is disabled by default and only works in the main thread.
+ */
+class FrameProfiler : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
+
+public:
+    /**
+     * @brief The Category enum defines what kind of work is measured by a ProfilerScope
+     */
+    enum Category {
+        BlockUpdate,  //!< the per-frame slot of a block (connected to Engine::updateBlocks)
+        DataCascade  //!< the propagation of changed data from an output node
+    };
+
+    explicit FrameProfiler(QObject* parent = nullptr);
+    ~FrameProfiler();
+
+    /**
+     * @brief instance returns the FrameProfiler of the engine, used by ProfilerScope
+     * @return a pointer to the FrameProfiler or nullptr
+     */
+    static FrameProfiler* instance() { return s_instance; }
+
+    /**
+     * @brief isActive returns true if profiling is enabled (fast check to be used in hot paths)
+     * @return true if profiling is enabled
+     */
+    static bool isActive() { return s_instance && s_instance->m_enabled; }
+
+    // ------------------- to be called by the Engine:
+
+    /**
+     * @brief beginFrame is called at the beginning of Engine::tick()
+     * @param timeSinceLastFrame the time in seconds since the last frame
+     * @param targetPeriod the target time in seconds between two frames
+     */
+    void beginFrame(double timeSinceLastFrame, double targetPeriod);
+    /**
+     * @brief beginOutputStage is called after the blocks have been updated
+     */
+    void beginOutputStage();
+    /**
+     * @brief endFrame is called at the end of Engine::tick() and adds the frame to the history
+     */
+    void endFrame();
+
+    // ------------------- to be called by ProfilerScope:
+
+    /**
+     * @brief addBlockTime adds a measured duration to the current frame
+     * @param block the block the time is attributed to
+     * @param category what kind of work was measured
+     * @param seconds the duration
+     */
+    void addBlockTime(BlockInterface* block, Category category, double seconds);
+
+signals:
+    void enabledChanged();
+    /**
+     * @brief historyChanged is emitted after a new frame was added to the history
+     */
+    void historyChanged();
+
+public slots:
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool value);
+
+    /**
+     * @brief clear removes all recorded frames
+     */
+    void clear();
+
+    /**
+     * @brief getFrameHistory returns the recorded frames (oldest first) to be displayed in QML
+     * @return a list of maps with the keys frame, tick, jitter, blocks and output (in ms)
+     */
+    QVariantList getFrameHistory() const;
+
+    /**
+     * @brief getBlockRanking returns the blocks that consumed the most time in the recorded frames
+     * @param count maximum number of blocks to return
+     * @return a list of maps with the keys uid, name, update, cascade, total and max (average ms per frame)
+     */
+    QVariantList getBlockRanking(int count = 10) const;
+
+    /**
+     * @brief getAverageTickDuration returns the average duration of Engine::tick()
+     * @return the average duration in ms
+     */
+    double getAverageTickDuration() const;
+
+    /**
+     * @brief getMaxJitter returns the maximum absolute jitter of the recorded frames
+     * @return the jitter in ms
+     */
+    double getMaxJitter() const;
+
+    /**
+     * @brief dumpToFile writes the recorded frames and block times to a CSV file
+     * @param filename the absolute path of the file to write
+     * @return true if successful
+     */
+    bool dumpToFile(QString filename) const;
+
+protected:
+    typedef std::chrono::steady_clock clock;
+
+    bool m_enabled;  //!< true if profiling is enabled
+    bool m_frameActive;  //!< true between beginFrame() and endFrame()
+    quint64 m_frameNumber;  //!< number of the current frame
+    clock::time_point m_frameStart;  //!< time beginFrame() was called
+    clock::time_point m_outputStart;  //!< time beginOutputStage() was called
+    ProfiledFrame m_currentFrame;  //!< the frame that is currently recorded
+    QHash<QString, int> m_currentBlockIndex;  //!< maps block UIDs to their index in m_currentFrame.blocks
+    QHash<QString, QString> m_blockNames;  //!< UI names of all blocks seen so far
+    Qt3DCore::QCircularBuffer<ProfiledFrame> m_history;  //!< ring buffer of the last frames
+
+    static FrameProfiler* s_instance;  //!< the instance used by ProfilerScope
+};
+
+
+/**
+ * @brief An object of the ProfilerScope class measures the time between its construction and
+ * destruction and adds it to the current frame of the FrameProfiler.
+ * Like HsvDataModifier it should only be used as a stack variable.
+ * It does nothing if profiling is disabled.
+ */
+class ProfilerScope {
+
+public:
+    ProfilerScope(BlockInterface* block, FrameProfiler::Category category)
+        : m_block(FrameProfiler::isActive() ? block : nullptr)
+        , m_category(category)
+        , m_parent(nullptr)
+        , m_childTime(0.0)
+    {
+        if (!m_block) return;
+        m_parent = s_current;
+        s_current = this;
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    ~ProfilerScope();
+
+    ProfilerScope(const ProfilerScope&) = delete;
+    ProfilerScope& operator=(const ProfilerScope&) = delete;
+
+protected:
+    BlockInterface* const m_block;
+    const FrameProfiler::Category m_category;
+    ProfilerScope* m_parent;  //!< the enclosing scope or nullptr
+    double m_childTime;  //!< time in seconds spent in nested scopes
+    std::chrono::steady_clock::time_point m_start;
+
+    static ProfilerScope* s_current;  //!< the innermost active scope
+};
+
+#endif // FRAMEPROFILER_H
@@ -11,8 +11,10 @@ EosActiveChannelsManager::EosActiveChannelsManager(MainController* controller)
 {
     connect(controller->eosManager(), SIGNAL(connectionEstablished()),
             this, SLOT(onConnectionEstablished()));
-    connect(controller->eosManager(), SIGNAL(eosMessageReceived(EosOSCMessage)),
-            this, SLOT(onIncomingEosMessage(EosOSCMessage)));
+    EosMessageRouter* router = controller->eosManager()->router();
+    auto handler = [this](const EosOSCMessage& msg) { onIncomingEosMessage(msg); };
+    router->addRoute("active/chan/...", this, handler);
+    router->addRoute("active/wheel/...", this, handler);
 }
 
 void EosActiveChannelsManager::onConnectionEstablished() {
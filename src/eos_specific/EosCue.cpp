@@ -144,6 +144,7 @@ void EosCue::update(const EosOSCMessage& msg)
         m_scene = "";
     }
 
+    m_message = msg;
     m_isValid = true;
     emit dataChanged();
 }
@@ -100,6 +100,12 @@ public:
      */
     void update(const EosOSCMessage& msg);
 
+    /**
+     * @brief getMessage returns the last valid OSC message this cue was updated with
+     * @return message with cue information, i.e. to store it in a cache
+     */
+    const EosOSCMessage& getMessage() const { return m_message; }
+
 signals:
     /**
      * @brief deleted is emitted when this cue was deleted
@@ -228,6 +234,8 @@ protected:
 
     bool m_isValid;  //!< true if this cue is valid
 
+    EosOSCMessage m_message;  //!< last valid message with information about this cue
+
     EosCueNumber m_cueNumber;  //!< cue number of this cue
 
     int m_index;  //!< see Eos manual
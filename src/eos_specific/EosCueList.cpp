@@ -18,6 +18,8 @@ EosCueList::EosCueList(MainController* controller)
     , m_soloMode(false)
     , m_timecodeList(-1)
     , m_oosSync(false)
+    , m_cuesConfirmed(false)
+    , m_pendingCueCount(0)
 {
 
 }
@@ -35,19 +37,21 @@ EosCueList::EosCueList(MainController* controller, const EosOSCMessage& msg)
     , m_soloMode(false)
     , m_timecodeList(-1)
     , m_oosSync(false)
+    , m_cuesConfirmed(false)
+    , m_pendingCueCount(0)
 {
     m_cueList = msg.pathPart(2);
 
     m_cuesChangedSignalDelay.setSingleShot(true);
     m_cuesChangedSignalDelay.setInterval(500);
     connect(&m_cuesChangedSignalDelay, SIGNAL(timeout()), this, SIGNAL(cuesChanged()));
-    connect(controller->eosManager(), SIGNAL(eosMessageReceived(EosOSCMessage)),
-            this, SLOT(onIncomingEosMessage(EosOSCMessage)));
+    // only messages of this cue list are passed to onIncomingEosMessage():
+    EosMessageRouter* router = controller->eosManager()->router();
+    auto handler = [this](const EosOSCMessage& msg) { onIncomingEosMessage(msg); };
+    router->addRoute("get/cue/" + m_cueList + "/...", this, handler);
+    router->addRoute("notify/cue/" + m_cueList + "/...", this, handler);
 
     update(msg);
-
-    QString message = "/eos/get/cue/" + m_cueList + "/count";
-    m_controller->lightingConsole()->sendMessage(message);
 }
 
 void EosCueList::update(const EosOSCMessage& msg) {
@@ -89,6 +93,7 @@ void EosCueList::update(const EosOSCMessage& msg) {
     m_timecodeList = args[11].toInt();
     m_oosSync = args[12].toBool();
 
+    m_infoMessage = msg;
     m_isValid = true;
     emit dataChanged();
 }
@@ -101,24 +106,32 @@ void EosCueList::onIncomingEosMessage(const EosOSCMessage& msg) {
     if (msg.pathPart(0) == "get") {
         if (msg.pathPart(3) == "count") {
             // this message contains the number of existing cues in this cuelist
+            m_controller->cueListManager()->onRequestAnswered();
             int cueCount = msg.numericValue();
-            // request details for each cue:
+            if (m_cuesConfirmed && cueCount == m_cues.size()) {
+                // the cues received in this session are still valid,
+                // changes are notified by the console:
+                return;
+            }
+            // request details for each cue,
+            // the known cues (i.e. from the cache) are shown until the console sent them again:
+            m_cuesConfirmed = false;
+            m_unconfirmedCues = m_cues;
+            m_pendingCueCount = cueCount;
             for (int i=0; i<cueCount; ++i) {
-                QString message = "/eos/get/cue/" + m_cueList + "/index/" + QString::number(i);
-                m_controller->lightingConsole()->sendMessage(message);
+                m_controller->cueListManager()->requestFromConsole("/eos/get/cue/" + m_cueList + "/index/" + QString::number(i));
             }
+            if (cueCount == 0) removeUnconfirmedCues();
         } else if (msg.path().size() <= 5) {
             // this message contains detailed information about a cue
-            EosCueNumber cueNumber = EosCueNumber(msg.pathPart(2), msg.pathPart(3), msg.pathPart(4));
-            if (m_cues.contains(cueNumber)) {
-                if (!m_cues[cueNumber]) return;
-                m_cues[cueNumber]->update(msg);
-            } else if (!msg.arguments().isEmpty()) {
-                EosCue* newCue = new EosCue(m_controller, msg);
-                connect(newCue, SIGNAL(deleted(EosCueNumber)), this, SLOT(deleteCue(EosCueNumber)));
-                m_cues[cueNumber] = newCue;
+            // (fx, links and actions of a cue are sent in additional messages with a longer path)
+            m_controller->cueListManager()->onRequestAnswered();
+            updateCue(msg);
+            if (m_pendingCueCount > 0) {
+                m_unconfirmedCues.remove(EosCueNumber(msg.pathPart(2), msg.pathPart(3), msg.pathPart(4)));
+                --m_pendingCueCount;
+                if (m_pendingCueCount == 0) removeUnconfirmedCues();
             }
-            m_cuesChangedSignalDelay.start();
         }
     } else if (msg.pathPart(0) == "notify") {
         // this message contains a list of changed cues as arguments
@@ -146,6 +159,48 @@ void EosCueList::onIncomingEosMessage(const EosOSCMessage& msg) {
     }
 }
 
+void EosCueList::updateCue(const EosOSCMessage& msg) {
+    EosCueNumber cueNumber = EosCueNumber(msg.pathPart(2), msg.pathPart(3), msg.pathPart(4));
+    if (m_cues.contains(cueNumber)) {
+        if (!m_cues[cueNumber]) return;
+        m_cues[cueNumber]->update(msg);
+    } else if (!msg.arguments().isEmpty()) {
+        EosCue* newCue = new EosCue(m_controller, msg);
+        connect(newCue, SIGNAL(deleted(EosCueNumber)), this, SLOT(deleteCue(EosCueNumber)));
+        m_cues[cueNumber] = newCue;
+    }
+    m_cuesChangedSignalDelay.start();
+}
+
+void EosCueList::removeUnconfirmedCues() {
+    for (auto it = m_unconfirmedCues.begin(); it != m_unconfirmedCues.end(); ++it) {
+        m_cues.remove(it.key());
+        delete it.value();
+    }
+    if (!m_unconfirmedCues.isEmpty()) m_cuesChangedSignalDelay.start();
+    m_unconfirmedCues.clear();
+    m_cuesConfirmed = true;
+}
+
+void EosCueList::clearCues() {
+    if (m_cues.isEmpty()) return;
+    for (EosCue* cue: m_cues.values()) {
+        delete cue;
+    }
+    m_cues.clear();
+    m_unconfirmedCues.clear();
+    m_cuesChangedSignalDelay.start();
+}
+
+QVector<EosOSCMessage> EosCueList::getCueMessages() const {
+    QVector<EosOSCMessage> messages;
+    messages.reserve(m_cues.size());
+    for (const QPointer<EosCue>& cue: m_cues) {
+        if (cue && cue->isValid()) messages.append(cue->getMessage());
+    }
+    return messages;
+}
+
 void EosCueList::deleteCue(const EosCueNumber& cueNumber) {
     if (m_cues.contains(cueNumber)) {
         m_cues.remove(cueNumber);
@@ -197,15 +252,15 @@ double EosCueList::getActiveCueIndex() const {
 }
 
 void EosCueList::onNotifyCueChanged(QString changedCue) {
-    QString message = "/eos/get/cue/" + m_cueList + "/" + changedCue;
-    m_controller->lightingConsole()->sendMessage(message);
+    // requests of cues that are already queued are not sent twice:
+    EosCueListManager* manager = m_controller->cueListManager();
+    manager->requestFromConsole("/eos/get/cue/" + m_cueList + "/" + changedCue);
     // this message could also mean a part of that cue
-    // -> request details for all parts:
-    for (const EosCueNumber& cueNumber: m_cues.keys()) {
-        if (cueNumber.number == changedCue && cueNumber.part != 0) {
-            QString part = QString::number(cueNumber.part);
-            QString message = "/eos/get/cue/" + m_cueList + "/" + changedCue + "/" + part;
-            m_controller->lightingConsole()->sendMessage(message);
-        }
+    // -> request details for all parts (they follow part 0 in the sorted map):
+    const EosCueNumber firstPart(m_cueList, changedCue, "1");
+    for (auto it = m_cues.lowerBound(firstPart); it != m_cues.end(); ++it) {
+        if (it.key().numberAsInt != firstPart.numberAsInt) break;
+        QString part = QString::number(it.key().part);
+        manager->requestFromConsole("/eos/get/cue/" + m_cueList + "/" + changedCue + "/" + part);
     }
 }
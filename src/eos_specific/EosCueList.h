@@ -16,6 +16,9 @@ class MainController;
 
 /**
  * @brief The EosCueList class represents a Cue List of an Eos console.
+ *
+ * Cues that were not received from the console in this session (i.e. from the cache) are kept
+ * until all cues were requested again, cues the console didn't send then are removed.
  */
 class EosCueList : public QObject
 {
@@ -42,6 +45,35 @@ public:
      */
     void update(const EosOSCMessage& msg);
 
+    /**
+     * @brief updateCue creates or updates a cue with an OSC message
+     * @param msg OSC message with information about a cue in this list
+     */
+    void updateCue(const EosOSCMessage& msg);
+
+    /**
+     * @brief clearCues deletes all cues in this list
+     */
+    void clearCues();
+
+    /**
+     * @brief getUid returns the Eos UID of this cue list
+     * @return UID string or an empty string if not known yet
+     */
+    QString getUid() const { return m_uid; }
+
+    /**
+     * @brief getInfoMessage returns the last valid OSC message this cue list was updated with
+     * @return message with cue list information, i.e. to store it in a cache
+     */
+    const EosOSCMessage& getInfoMessage() const { return m_infoMessage; }
+
+    /**
+     * @brief getCueMessages returns the last messages of all valid cues in this list
+     * @return messages with cue information, i.e. to store them in a cache
+     */
+    QVector<EosOSCMessage> getCueMessages() const;
+
 signals:
     /**
      * @brief deleted is emitted when this cue list was deleted
@@ -110,6 +142,12 @@ protected slots:
     void onNotifyCueChanged(QString changedCue);
 
 protected:
+    /**
+     * @brief removeUnconfirmedCues deletes the cues that the console didn't send again
+     * after all cues were requested
+     */
+    void removeUnconfirmedCues();
+
     MainController* const m_controller;  //!< a pointer to the MainController
 
     bool m_isValid;  //!< true if this cue list is valid
@@ -133,8 +171,14 @@ protected:
     int m_timecodeList;  //!< see Eos manual
     bool m_oosSync;  //!< see Eos manual
 
+    EosOSCMessage m_infoMessage;  //!< last valid message with information about this cue list
+
     QTimer m_cuesChangedSignalDelay;  //!< timer to delay the cues changed signal
 
+    bool m_cuesConfirmed;  //!< true if all cues were received from the console in this session
+    QMap<EosCueNumber, QPointer<EosCue>> m_unconfirmedCues;  //!< cues not sent again by the console yet
+    int m_pendingCueCount;  //!< number of requested cues that were not received yet
+
 };
 
 #endif // EOSCUELIST_H
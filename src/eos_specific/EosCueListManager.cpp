@@ -3,22 +3,80 @@
 #include "core/MainController.h"
 
 #include <QTimer>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QtConcurrent>
+
+// directory of the cached cue lists in the data dir:
+static const QString CACHE_DIR = "eos_cache";
+// first bytes of a cache file and version of its format:
+static const quint32 CACHE_MAGIC = 0x4c454351;
+static const quint32 CACHE_FORMAT_VERSION = 1;
+
+// cue list information message and messages of its cues:
+typedef QPair<EosOSCMessage, QVector<EosOSCMessage>> CachedCueList;
+
+// serializes and compresses the cache, called in a background thread:
+static void writeCacheFile(FileSystemManager* dao, QString filename, QString showTitle,
+                           QString consoleVersion, QVector<CachedCueList> cueLists) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << CACHE_MAGIC << CACHE_FORMAT_VERSION;
+    out << showTitle << consoleVersion;
+    out << qint32(cueLists.size());
+    for (const CachedCueList& cueList: cueLists) {
+        out << cueList.first << cueList.second;
+    }
+    dao->saveFile(CACHE_DIR, filename, qCompress(data));
+}
 
 
 EosCueListManager::EosCueListManager(MainController* controller)
     : QObject(controller)
     , m_controller(controller)
     , m_dummyCueList(controller)
+    , m_requestsInFlight(0)
+    , m_syncRequestCount(0)
+    , m_syncAnsweredCount(0)
+    , m_syncTimedOut(false)
 {
     qmlRegisterType<EosCueList>();
     qmlRegisterType<EosCue>();
 
     connect(controller->eosManager(), SIGNAL(connectionEstablished()),
             this, SLOT(onConnectionEstablished()));
-    connect(controller->eosManager(), SIGNAL(eosMessageReceived(EosOSCMessage)),
-            this, SLOT(onIncomingEosMessage(EosOSCMessage)));
+    EosMessageRouter* router = controller->eosManager()->router();
+    auto handler = [this](const EosOSCMessage& msg) { onIncomingEosMessage(msg); };
+    router->addRoute("get/cuelist/...", this, handler);
+    router->addRoute("notify/cuelist/...", this, handler);
     connect(controller->eosManager(), SIGNAL(connectionReset()),
             this, SLOT(onConnectionReset()));
+    connect(controller->eosManager(), SIGNAL(showTitleChanged()),
+            this, SLOT(loadCache()));
+    connect(controller->eosManager(), SIGNAL(consoleVersionChanged()),
+            this, SLOT(loadCache()));
+
+    m_requestTimeout.setSingleShot(true);
+    m_requestTimeout.setInterval(EosCueListManagerConstants::requestTimeout);
+    connect(&m_requestTimeout, SIGNAL(timeout()), this, SLOT(onRequestTimeout()));
+
+    m_syncProgressSignalDelay.setSingleShot(true);
+    m_syncProgressSignalDelay.setInterval(100);
+    connect(&m_syncProgressSignalDelay, SIGNAL(timeout()), this, SIGNAL(syncProgressChanged()));
+
+    m_saveCacheDelay.setSingleShot(true);
+    m_saveCacheDelay.setInterval(EosCueListManagerConstants::cacheSaveDelay);
+    connect(&m_saveCacheDelay, SIGNAL(timeout()), this, SLOT(saveCache()));
+}
+
+EosCueListManager::~EosCueListManager() {
+    m_cacheWriter.waitForFinished();
+    if (m_saveCacheDelay.isActive()) {
+        m_saveCacheDelay.stop();
+        saveCache();
+    }
+    m_cacheWriter.waitForFinished();
 }
 
 void EosCueListManager::onConnectionEstablished() {
@@ -31,40 +89,58 @@ void EosCueListManager::onIncomingEosMessage(const EosOSCMessage& msg) {
     if (msg.pathPart(0) == "get") {
         if (msg.pathPart(2) == "count") {
             // this message contains the number of existing cuelists
-            // reset existing data:
-            clear();
+            // the queued requests belong to the previous synchronization:
+            discardQueuedRequests();
+            // the known lists (i.e. from the cache or before a reconnect) are kept
+            // if the console confirms them until the end of the synchronization:
+            m_unconfirmedCueLists = m_cueLists.keys().toSet();
             int cueListCount = msg.numericValue();
             // request details for each cuelists:
             for (int i=0; i<cueListCount; ++i) {
-                QString message = "/eos/get/cuelist/index/" + QString::number(i);
-                m_controller->lightingConsole()->sendMessage(message);
+                requestFromConsole("/eos/get/cuelist/index/" + QString::number(i));
             }
+            onRequestAnswered();
         } else if (msg.pathPart(3) == "links") {
             // this message contains information about linked cue lists
             // NOTE: not implemented yet
         } else {
             // this message contains detailed information about a cuelist
             int cueListNumber = msg.pathPart(2).toInt();
-            if (m_cueLists.contains(cueListNumber)) {
-                m_cueLists[cueListNumber]->update(msg);
-            } else {
-                EosCueList* newCueList = new EosCueList(m_controller, msg);
-                connect(newCueList, SIGNAL(deleted(int)), this, SLOT(deleteCueList(int)));
-                m_cueLists[cueListNumber] = newCueList;
+            m_unconfirmedCueLists.remove(cueListNumber);
+            if (m_cueLists.contains(cueListNumber) && m_cueLists[cueListNumber]) {
+                EosCueList* cueList = m_cueLists[cueListNumber];
+                const QString previousUid = cueList->getUid();
+                cueList->update(msg);
+                if (!msg.arguments().isEmpty() && cueList->getUid() != previousUid) {
+                    // this is a different list with the same number (i.e. another show):
+                    cueList->clearCues();
+                }
+            } else if (!msg.arguments().isEmpty()) {
+                addCueList(new EosCueList(m_controller, msg));
+            }
+            if (!msg.arguments().isEmpty()) {
+                // the cues are requested again unless they are confirmed and their count is unchanged:
+                requestFromConsole("/eos/get/cue/" + QString::number(cueListNumber) + "/count");
             }
             emit cueListsChanged();
+            onRequestAnswered();
         }
     } else if (msg.pathPart(0) == "notify") {
         // this message contains a list of changed cue lists as arguments
         // ignore first argument, get details for the other:
+        // (a list that is already queued is not requested twice)
         for (int i=1; i<msg.arguments().size(); ++i) {
             int changedCueList = msg.arguments().at(i).toInt();
-            QString message = "/eos/get/cuelist/" + QString::number(changedCueList);
-            m_controller->lightingConsole()->sendMessage(message);
+            requestFromConsole("/eos/get/cuelist/" + QString::number(changedCueList));
         }
     }
 }
 
+void EosCueListManager::addCueList(EosCueList* cueList) {
+    connect(cueList, SIGNAL(deleted(int)), this, SLOT(deleteCueList(int)));
+    m_cueLists[cueList->getInfoMessage().pathPart(2).toInt()] = cueList;
+}
+
 void EosCueListManager::deleteCueList(int cueList) {
     if (m_cueLists.contains(cueList)) {
         m_cueLists.remove(cueList);
@@ -81,9 +157,88 @@ EosCueList* EosCueListManager::getCueList(int cueListNumber) const {
     return cueList;
 }
 
+void EosCueListManager::requestFromConsole(QString message) {
+    if (m_queuedRequests.contains(message)) return;
+    m_requestQueue.append(message);
+    m_queuedRequests.insert(message);
+    ++m_syncRequestCount;
+    sendQueuedRequests();
+    if (!m_syncProgressSignalDelay.isActive()) m_syncProgressSignalDelay.start();
+}
+
+void EosCueListManager::onRequestAnswered() {
+    if (m_requestsInFlight <= 0) return;  // not requested by this manager or already timed out
+    --m_requestsInFlight;
+    ++m_syncAnsweredCount;
+    if (m_requestsInFlight > 0) {
+        m_requestTimeout.start();
+    } else {
+        m_requestTimeout.stop();
+    }
+    sendQueuedRequests();
+    if (!m_syncProgressSignalDelay.isActive()) m_syncProgressSignalDelay.start();
+}
+
+double EosCueListManager::getSyncProgress() const {
+    if (m_syncRequestCount <= 0) return 1.0;
+    return m_syncAnsweredCount / double(m_syncRequestCount);
+}
+
+void EosCueListManager::sendQueuedRequests() {
+    while (m_requestsInFlight < EosCueListManagerConstants::maxRequestsInFlight
+           && !m_requestQueue.isEmpty()) {
+        QString message = m_requestQueue.takeFirst();
+        m_queuedRequests.remove(message);
+        m_controller->lightingConsole()->sendMessage(message);
+        ++m_requestsInFlight;
+        m_requestTimeout.start();
+    }
+    if (m_requestsInFlight == 0 && m_requestQueue.isEmpty() && m_syncRequestCount > 0) {
+        // synchronization finished:
+        m_syncRequestCount = 0;
+        m_syncAnsweredCount = 0;
+        onSyncFinished();
+        emit syncProgressChanged();
+    }
+}
+
+void EosCueListManager::onSyncFinished() {
+    if (!m_syncTimedOut) {
+        // lists that were not confirmed by the console don't exist anymore:
+        bool changed = false;
+        for (int cueListNumber: m_unconfirmedCueLists) {
+            if (!m_cueLists.contains(cueListNumber)) continue;
+            delete m_cueLists[cueListNumber];
+            m_cueLists.remove(cueListNumber);
+            changed = true;
+        }
+        if (changed) emit cueListsChanged();
+        // the lists are now the ones of the show loaded on the console:
+        setCacheKey();
+        m_saveCacheDelay.start();
+    }
+    m_unconfirmedCueLists.clear();
+    m_syncTimedOut = false;
+}
+
+void EosCueListManager::onRequestTimeout() {
+    // the answers are probably lost (i.e. connection lost), don't wait for them:
+    m_syncTimedOut = true;
+    m_syncAnsweredCount += m_requestsInFlight;
+    m_requestsInFlight = 0;
+    sendQueuedRequests();
+    if (!m_syncProgressSignalDelay.isActive()) m_syncProgressSignalDelay.start();
+}
+
+void EosCueListManager::discardQueuedRequests() {
+    m_syncRequestCount -= m_requestQueue.size();
+    m_requestQueue.clear();
+    m_queuedRequests.clear();
+    sendQueuedRequests();
+}
+
 void EosCueListManager::requestCueListCount() {
-    QString message = "/eos/get/cuelist/count";
-    m_controller->lightingConsole()->sendMessage(message);
+    requestFromConsole("/eos/get/cuelist/count");
 }
 
 void EosCueListManager::clear() {
@@ -95,5 +250,93 @@ void EosCueListManager::clear() {
 }
 
 void EosCueListManager::onConnectionReset() {
+    // another show was loaded, keep the cache of the previous one:
+    // (the show title may already be the one of the new show, saveCache() uses the stored one)
+    m_saveCacheDelay.stop();
+    m_cacheWriter.waitForFinished();
+    saveCache();
+    clear();
+    m_cacheShowTitle.clear();
+    m_cacheConsoleVersion.clear();
     QTimer::singleShot(500, this, SLOT(requestCueListCount()));
 }
+
+QString EosCueListManager::getCacheFilename(const QString& showTitle, const QString& consoleVersion) {
+    if (showTitle.isEmpty() || consoleVersion.isEmpty()) return "";
+    QByteArray key = (showTitle + "\n" + consoleVersion).toUtf8();
+    return QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex() + ".cache";
+}
+
+void EosCueListManager::setCacheKey() {
+    m_cacheShowTitle = m_controller->eosManager()->getShowTitle();
+    m_cacheConsoleVersion = m_controller->eosManager()->getConsoleVersion();
+}
+
+void EosCueListManager::saveCache() {
+    // don't save an incomplete state:
+    if (getSyncing() || m_cueLists.isEmpty()) return;
+    const QString filename = getCacheFilename(m_cacheShowTitle, m_cacheConsoleVersion);
+    if (filename.isEmpty()) return;
+    if (m_cacheWriter.isRunning()) {
+        // the previous cache is still written, try again later:
+        m_saveCacheDelay.start();
+        return;
+    }
+
+    // only the messages are copied here, they are serialized and compressed in the background:
+    QVector<CachedCueList> cueLists;
+    for (const QPointer<EosCueList>& cueList: m_cueLists) {
+        if (cueList && cueList->isValid()) {
+            cueLists.append(CachedCueList(cueList->getInfoMessage(), cueList->getCueMessages()));
+        }
+    }
+    m_cacheWriter = QtConcurrent::run(writeCacheFile, m_controller->dao(), filename,
+                                      m_cacheShowTitle, m_cacheConsoleVersion, cueLists);
+}
+
+void EosCueListManager::loadCache() {
+    // the cache is only used if there is no data yet:
+    if (!m_cueLists.isEmpty()) return;
+    // lists received from now on belong to this show:
+    setCacheKey();
+    const QString filename = getCacheFilename(m_cacheShowTitle, m_cacheConsoleVersion);
+    if (filename.isEmpty() || !m_controller->dao()->fileExists(CACHE_DIR, filename)) return;
+    // a cache of this show that is written right now is complete after this:
+    m_cacheWriter.waitForFinished();
+
+    QByteArray data = qUncompress(m_controller->dao()->loadFile(CACHE_DIR, filename));
+    QDataStream in(&data, QIODevice::ReadOnly);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    QString showTitle;
+    QString consoleVersion;
+    qint32 cueListCount = 0;
+    in >> magic >> formatVersion >> showTitle >> consoleVersion >> cueListCount;
+    if (in.status() != QDataStream::Ok || magic != CACHE_MAGIC || formatVersion != CACHE_FORMAT_VERSION
+            || showTitle != m_cacheShowTitle || consoleVersion != m_cacheConsoleVersion) {
+        qWarning() << "Eos cue list cache is invalid.";
+        return;
+    }
+
+    for (int i=0; i<cueListCount; ++i) {
+        EosOSCMessage infoMessage;
+        QVector<EosOSCMessage> cueMessages;
+        in >> infoMessage >> cueMessages;
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "Eos cue list cache is incomplete.";
+            break;
+        }
+        EosCueList* cueList = new EosCueList(m_controller, infoMessage);
+        if (!cueList->isValid()) {
+            delete cueList;
+            continue;
+        }
+        for (const EosOSCMessage& cueMessage: cueMessages) {
+            cueList->updateCue(cueMessage);
+        }
+        addCueList(cueList);
+    }
+    emit cueListsChanged();
+    // the cached lists are validated by the next synchronization
+}
@@ -7,24 +7,62 @@
 #include <QObject>
 #include <QPointer>
 #include <QMap>
+#include <QSet>
+#include <QTimer>
+#include <QFuture>
 
 // forward declaration to prevent dependency loop
 class MainController;
 
 
+/**
+ * @brief The EosCueListManagerConstants namespace contains all constants used in EosCueListManager.
+ */
+namespace EosCueListManagerConstants {
+    /**
+     * @brief maxRequestsInFlight maximum number of get requests sent to the console without an answer
+     */
+    static const int maxRequestsInFlight = 8;
+    /**
+     * @brief requestTimeout time after which missing answers are ignored in ms
+     */
+    static const int requestTimeout = 2000;  // in ms
+    /**
+     * @brief cacheSaveDelay time after the last synchronization until the cache is written in ms
+     */
+    static const int cacheSaveDelay = 5000;  // in ms
+}
+
+
 /**
  * @brief The EosCueListManager class manages all Eos Cue Lists.
+ *
+ * All get requests of cue lists and cues are sent through a queue with a bounded number
+ * of requests in flight, so that a large show doesn't flood the console and the UI
+ * while synchronizing. Requests that are already queued are not queued again.
+ *
+ * The cue lists and cues are cached on disk per show title and console version, so that
+ * they are available immediately after a restart. The cached lists are validated with their UID,
+ * the cached cues are shown until the console sent them again (see EosCueList).
+ * The cache is written in a background thread shortly after a synchronization finished.
  */
 class EosCueListManager : public QObject
 {
     Q_OBJECT
 
+    Q_PROPERTY(bool syncing READ getSyncing NOTIFY syncProgressChanged)
+    Q_PROPERTY(double syncProgress READ getSyncProgress NOTIFY syncProgressChanged)
+
 public:
     /**
      * @brief EosCueListManager creates an EosCueListManager object
      * @param controller a pointer to the MainController
      */
     explicit EosCueListManager(MainController* controller);
+    /**
+     * @brief ~EosCueListManager writes a pending cache and waits until it is written
+     */
+    ~EosCueListManager();
 
 signals:
     /**
@@ -32,6 +70,11 @@ signals:
      */
     void cueListsChanged();
 
+    /**
+     * @brief syncProgressChanged is emitted when the synchronization progress changed
+     */
+    void syncProgressChanged();
+
 public slots:
     /**
      * @brief onConnectionEstablished requests cue list information when an OSC connection was
@@ -63,6 +106,30 @@ public slots:
      */
     EosCueList* getCueList(int cueListNumber) const;
 
+    /**
+     * @brief requestFromConsole queues a get request, it is sent when less than
+     * maxRequestsInFlight requests are waiting for an answer
+     * @param message the request, i.e. "/eos/get/cue/1/index/0"
+     */
+    void requestFromConsole(QString message);
+
+    /**
+     * @brief onRequestAnswered is called when the answer to a get request was received
+     */
+    void onRequestAnswered();
+
+    /**
+     * @brief getSyncing returns if cue lists or cues are currently synchronized
+     * @return true if requests are queued or waiting for an answer
+     */
+    bool getSyncing() const { return m_syncRequestCount > 0; }
+
+    /**
+     * @brief getSyncProgress returns the progress of the current synchronization
+     * @return answered requests / all requests of this synchronization [0...1]
+     */
+    double getSyncProgress() const;
+
 private slots:
     /**
      * @brief requestCueListCount request the count of cue lists from the console
@@ -77,12 +144,76 @@ private slots:
      */
     void onConnectionReset();
 
+    /**
+     * @brief sendQueuedRequests sends queued requests until the in flight limit is reached
+     */
+    void sendQueuedRequests();
+    /**
+     * @brief onRequestTimeout is called when the console didn't answer for some time,
+     * requests in flight are regarded as lost
+     */
+    void onRequestTimeout();
+    /**
+     * @brief discardQueuedRequests removes all requests that are not yet sent
+     */
+    void discardQueuedRequests();
+    /**
+     * @brief onSyncFinished removes lists that don't exist anymore and updates the cache
+     */
+    void onSyncFinished();
+
+    /**
+     * @brief loadCache creates the cue lists from the cache of the current show,
+     * if no lists exist yet
+     */
+    void loadCache();
+
+    /**
+     * @brief saveCache writes all cue lists and cues to the cache of the show they belong to,
+     * the file is written in a background thread
+     */
+    void saveCache();
+
 protected:
+    /**
+     * @brief addCueList adds a new cue list object to this manager
+     * @param cueList the new cue list
+     */
+    void addCueList(EosCueList* cueList);
+
+    /**
+     * @brief getCacheFilename returns the filename of the cache of a show
+     * @param showTitle title of the show
+     * @param consoleVersion software version of the console
+     * @return filename or an empty string if show title or console version are unknown
+     */
+    static QString getCacheFilename(const QString& showTitle, const QString& consoleVersion);
+
+    /**
+     * @brief setCacheKey sets the show the current cue lists belong to
+     * to the show currently loaded on the console
+     */
+    void setCacheKey();
+
     QPointer<MainController> const m_controller;  //!< a pointer to the MainController
 
     QMap<int, QPointer<EosCueList>> m_cueLists;  //!< map of cue list number and object
 
     mutable EosCueList m_dummyCueList;  //!< a dummy cue list to show if no cue lists available
+
+    QList<QString> m_requestQueue;  //!< get requests that are not yet sent, in order
+    QSet<QString> m_queuedRequests;  //!< set of the requests in m_requestQueue to find duplicates
+    int m_requestsInFlight;  //!< number of sent requests without an answer
+    int m_syncRequestCount;  //!< number of requests of the current synchronization
+    int m_syncAnsweredCount;  //!< number of answered requests of the current synchronization
+    QTimer m_requestTimeout;  //!< timer to detect lost requests
+    QTimer m_syncProgressSignalDelay;  //!< timer to delay the sync progress changed signal
+    bool m_syncTimedOut;  //!< true if answers of the current synchronization were lost
+    QSet<int> m_unconfirmedCueLists;  //!< known lists that the console didn't confirm yet
+    QString m_cacheShowTitle;  //!< title of the show the cue lists belong to
+    QString m_cacheConsoleVersion;  //!< console version of the show the cue lists belong to
+    QTimer m_saveCacheDelay;  //!< timer to write the cache once after a synchronization
+    QFuture<void> m_cacheWriter;  //!< background task that writes the cache
 };
 
 #endif // EOSCUELISTMANAGER_H
@@ -0,0 +1,182 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "EosMessageRouter.h"
+
+#include <QStringList>
+
+
+EosMessageRouter::EosMessageRouter(QObject* parent)
+	: QObject(parent)
+	, m_root(new Node())
+	, m_segmentIds()
+	, m_routes()
+	, m_receivers()
+	, m_lastRouteId(0)
+{
+
+}
+
+EosMessageRouter::~EosMessageRouter()
+{
+	deleteNode(m_root);
+}
+
+int EosMessageRouter::addRoute(const QString& shape, QObject* receiver, Handler handler)
+{
+	Route route;
+	for (const QString& part: shape.split(QLatin1Char('/'), QString::SkipEmptyParts)) {
+		if (part == QLatin1String("*")) {
+			route.shape.append(ANY_SEGMENT);
+		} else if (part == QLatin1String("...")) {
+			route.shape.append(ANY_REST);
+			break;  // nothing can follow
+		} else {
+			route.shape.append(internSegment(part));
+		}
+	}
+	route.receiver = receiver;
+	route.handler = handler;
+
+	const int routeId = ++m_lastRouteId;
+	const bool anyRest = !route.shape.isEmpty() && route.shape.last() == ANY_REST;
+	Node* node = getNode(route.shape, /*create*/ true);
+	if (anyRest) {
+		node->restRoutes.append(routeId);
+	} else {
+		node->routes.append(routeId);
+	}
+	m_routes.insert(routeId, route);
+
+	// remove the routes when the receiver is destroyed:
+	if (receiver && !m_receivers.contains(receiver)) {
+		m_receivers.insert(receiver);
+		connect(receiver, &QObject::destroyed, this, &EosMessageRouter::onReceiverDestroyed);
+	}
+	return routeId;
+}
+
+void EosMessageRouter::removeRoute(int routeId)
+{
+	auto it = m_routes.find(routeId);
+	if (it == m_routes.end()) return;
+
+	Node* node = getNode(it->shape, /*create*/ false);
+	if (node) {
+		node->routes.removeAll(routeId);
+		node->restRoutes.removeAll(routeId);
+	}
+	m_routes.erase(it);
+}
+
+void EosMessageRouter::removeRoutes(QObject* receiver)
+{
+	QVector<int> routeIds;
+	for (auto it = m_routes.cbegin(); it != m_routes.cend(); ++it) {
+		if (it->receiver == receiver) routeIds.append(it.key());
+	}
+	for (int routeId: routeIds) {
+		removeRoute(routeId);
+	}
+}
+
+bool EosMessageRouter::dispatch(const EosOSCMessage& msg) const
+{
+	// convert the path to segment IDs once,
+	// parts that are not used in any shape can only match "*" and "...":
+	const QStringList& path = msg.path();
+	QVarLengthArray<int, 16> ids(path.size());
+	for (int i=0; i<path.size(); ++i) {
+		ids[i] = m_segmentIds.value(path[i], UNKNOWN_SEGMENT);
+	}
+
+	// collect the matching routes first, because handlers may add or remove routes:
+	MatchList matches;
+	collectMatches(m_root, ids.constData(), ids.size(), matches);
+
+	for (int routeId: matches) {
+		auto it = m_routes.constFind(routeId);
+		if (it == m_routes.constEnd()) continue;  // removed by a previous handler
+		// copy the handler, the route could be removed while it is called:
+		Handler handler = it->handler;
+		handler(msg);
+	}
+	return !matches.isEmpty();
+}
+
+void EosMessageRouter::onReceiverDestroyed(QObject* receiver)
+{
+	removeRoutes(receiver);
+	m_receivers.remove(receiver);
+}
+
+int EosMessageRouter::internSegment(const QString& segment)
+{
+	auto it = m_segmentIds.constFind(segment);
+	if (it != m_segmentIds.constEnd()) return it.value();
+	const int id = m_segmentIds.size();
+	m_segmentIds.insert(segment, id);
+	return id;
+}
+
+void EosMessageRouter::collectMatches(const Node* node, const int* ids, int count, MatchList& matches) const
+{
+	for (int routeId: node->restRoutes) matches.append(routeId);
+	if (count == 0) {
+		for (int routeId: node->routes) matches.append(routeId);
+		return;
+	}
+	if (ids[0] != UNKNOWN_SEGMENT) {
+		const Node* child = node->children.value(ids[0], nullptr);
+		if (child) collectMatches(child, ids + 1, count - 1, matches);
+	}
+	if (node->anyChild) {
+		collectMatches(node->anyChild, ids + 1, count - 1, matches);
+	}
+}
+
+EosMessageRouter::Node* EosMessageRouter::getNode(const QVector<int>& shape, bool create)
+{
+	Node* node = m_root;
+	for (int id: shape) {
+		if (id == ANY_REST) break;
+		Node* child = (id == ANY_SEGMENT) ? node->anyChild : node->children.value(id, nullptr);
+		if (!child) {
+			if (!create) return nullptr;
+			child = new Node();
+			if (id == ANY_SEGMENT) {
+				node->anyChild = child;
+			} else {
+				node->children.insert(id, child);
+			}
+		}
+		node = child;
+	}
+	return node;
+}
+
+void EosMessageRouter::deleteNode(Node* node)
+{
+	for (Node* child: node->children) {
+		deleteNode(child);
+	}
+	if (node->anyChild) deleteNode(node->anyChild);
+	delete node;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef EOSMESSAGEROUTER_H
+#define EOSMESSAGEROUTER_H
+
+#include "eos_specific/EosOSCMessage.h"
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QVarLengthArray>
+#include <functional>
+
+
+/**
+ * @brief The EosMessageRouter class dispatches Eos OSC messages to the handlers
+ * registered for their path shape.
+ *
+ * A shape is the path of an EosOSCMessage (without "/eos/out/" and the user part)
+ * where "*" matches any single part and a trailing "..." matches any number of parts,
+ * i.e. "get/cue/1/..." or "active/wheel/*".
+ *
+ * The literal parts of all shapes are interned as integer IDs and stored in a tree.
+ * The path of a message is converted to IDs once, so a message only visits the
+ * handlers of matching shapes instead of every consumer comparing strings.
+ *
+ * A route is removed automatically when its receiver is destroyed.
+ */
+class EosMessageRouter : public QObject
+{
+	Q_OBJECT
+
+public:
+	typedef std::function<void(const EosOSCMessage&)> Handler;
+
+	explicit EosMessageRouter(QObject* parent = nullptr);
+	~EosMessageRouter();
+
+	/**
+	 * @brief addRoute registers a handler for all messages matching a path shape
+	 * @param shape path parts separated by slashes, "*" for any part, "..." at the end for any rest
+	 * @param receiver the route is removed when this object is destroyed
+	 * @param handler function to be called with matching messages
+	 * @return route ID to be used with removeRoute()
+	 */
+	int addRoute(const QString& shape, QObject* receiver, Handler handler);
+
+	/**
+	 * @brief removeRoute removes a single route
+	 * @param routeId ID returned by addRoute()
+	 */
+	void removeRoute(int routeId);
+
+	/**
+	 * @brief removeRoutes removes all routes of a receiver
+	 * @param receiver object used when adding the routes
+	 */
+	void removeRoutes(QObject* receiver);
+
+	/**
+	 * @brief dispatch calls the handlers of all routes matching the message
+	 * @param msg a complete Eos message
+	 * @return true if at least one route matched
+	 */
+	bool dispatch(const EosOSCMessage& msg) const;
+
+private slots:
+	void onReceiverDestroyed(QObject* receiver);
+
+private:
+	// segment IDs with a special meaning in a shape:
+	enum SpecialSegment { UNKNOWN_SEGMENT = -1, ANY_SEGMENT = -2, ANY_REST = -3 };
+
+	struct Route {
+		QVector<int> shape;
+		QObject* receiver;
+		Handler handler;
+	};
+
+	struct Node {
+		Node() : anyChild(nullptr) {}
+		QHash<int, Node*> children;
+		Node* anyChild;  // "*"
+		QVector<int> routes;  // shapes ending at this node
+		QVector<int> restRoutes;  // shapes ending at this node with "..."
+	};
+
+	typedef QVarLengthArray<int, 16> MatchList;
+
+	int internSegment(const QString& segment);
+	void collectMatches(const Node* node, const int* ids, int count, MatchList& matches) const;
+	Node* getNode(const QVector<int>& shape, bool create);
+	static void deleteNode(Node* node);
+
+	Node* m_root;
+	QHash<QString, int> m_segmentIds;  // interned literal parts of all shapes
+	QHash<int, Route> m_routes;
+	QSet<QObject*> m_receivers;
+	int m_lastRouteId;
+};
+
+#endif // EOSMESSAGEROUTER_H
@@ -18,13 +18,15 @@ EosOSCManager::EosOSCManager(MainController* controller)
     , m_faderBankCount(0)
     , m_timeouts(0)
     , m_discoveryClient(this)
+    , m_router(this)
 {
+    addMessageRoutes();
+
     connect(m_controller->lightingConsole(), SIGNAL(isConnectedChanged()),
             this, SLOT(onConnectionChanged()));
     connect(m_controller->lightingConsole(), SIGNAL(messageReceived(OSCMessage)),
             this, SLOT(onIncomingMessage(OSCMessage)));
 
-    m_startTime = HighResTime::now();
     m_latencyTimeout.setSingleShot(true);
     m_latencyTimeout.setInterval(EosOSCManagerConstants::latencyTimeout);
     connect(&m_latencyTimeout, SIGNAL(timeout()), this, SLOT(onLatencyTimeout()));
@@ -54,23 +56,29 @@ void EosOSCManager::onIncomingMessage(const OSCMessage& msg) {
     }
     //msg.printToQDebug();
 
-    // check if there is an incomplete message (i.e. from list convention):
-    if (msg.pathPart(-3) == "list" && m_incompleteMessage.isValid()
-            && m_incompleteMessage.canConvert<EosOSCMessage>()) {
-        // yes, there is an incomplete message and this message could be a continuation of it
-        EosOSCMessage incompleteMsg = m_incompleteMessage.value<EosOSCMessage>();
-        bool success = incompleteMsg.add(msg);
-        if (success) {
-            // messages were joined -> check if message is complete or exit:
-            if (incompleteMsg.isComplete()) {
-                m_incompleteMessage.clear();
-                onIncomingEosMessage(incompleteMsg);
-            }
+    // check if this is a part of an OSC List Convention message:
+    int baseLength = 0;
+    int listIndex = 0;
+    int listCount = 0;
+    const bool isListPart = EosOSCMessage::parseListConvention(msg.pathString(), baseLength, listIndex, listCount);
+    if (isListPart && listIndex > 0) {
+        // yes, this should be the continuation of an incomplete message with the same path:
+        auto it = m_incompleteMessages.find(msg.pathString().left(baseLength));
+        if (it == m_incompleteMessages.end()) {
+            qWarning() << "Discarded part of OSC List Convention message without beginning.";
+            return;
+        }
+        if (!it->add(listIndex, msg.arguments())) {
+            // the parts could not be joined, discard incomplete message:
+            m_incompleteMessages.erase(it);
             return;
-        } else {
-            // the two messages could not be joined, discard incomplete message:
-            m_incompleteMessage.clear();
         }
+        if (it->isComplete()) {
+            EosOSCMessage completeMsg = *it;
+            m_incompleteMessages.erase(it);
+            onIncomingEosMessage(completeMsg);
+        }
+        return;
     }
 
     // create a new message:
@@ -78,7 +86,13 @@ void EosOSCManager::onIncomingMessage(const OSCMessage& msg) {
     if (eosMsg.isComplete()) {
         onIncomingEosMessage(eosMsg);
     } else {
-        m_incompleteMessage = QVariant::fromValue<EosOSCMessage>(eosMsg);
+        if (m_incompleteMessages.size() >= EosOSCManagerConstants::maxIncompleteMessages) {
+            // the remaining parts of these messages were probably lost:
+            qWarning() << "Too many incomplete OSC List Convention messages, discarding them.";
+            m_incompleteMessages.clear();
+        }
+        // a previous incomplete message with the same path is replaced:
+        m_incompleteMessages.insert(isListPart ? msg.pathString().left(baseLength) : msg.pathString(), eosMsg);
     }
 }
 
@@ -90,32 +104,46 @@ void EosOSCManager::onIncomingEosMessage(const EosOSCMessage& msg) {
         m_latencyTimeout.start();
     }
     if (msg.path().isEmpty()) return;
-    if (msg.pathPart(0) == "user") {
+    if (!m_router.dispatch(msg)) {
+        // emit signal for messages without a route:
+        emit eosMessageReceived(msg);
+    }
+}
+
+void EosOSCManager::addMessageRoutes() {
+    m_router.addRoute("user", this, [this](const EosOSCMessage& msg) {
         setOscUserId(int(msg.numericValue()));
-    } else if (msg.pathPart(0) == "cmd") {
+    });
+    m_router.addRoute("cmd/...", this, [this](const EosOSCMessage& msg) {
         if (msg.userIdProvided()) {
             setCmdText(msg.userId(), msg.stringValue());
         }
-    } else if (msg.pathPart(0) == "show" && msg.pathPart(1) == "name") {
+    });
+    m_router.addRoute("show/name/...", this, [this](const EosOSCMessage& msg) {
         setShowTitle(msg.stringValue());
-    } else if (msg.pathPart(2) == "loaded" && msg.pathPart(1) == "show" && msg.pathPart(0) == "event") {
+    });
+    m_router.addRoute("event/show/loaded/...", this, [this](const EosOSCMessage&) {
         m_controller->lightingConsole()->sendMessage("/eos/reset");
         m_controller->lightingConsole()->sendMessage("/eos/subscribe=1");
         m_controller->lightingConsole()->sendMessage("/eos/get/version");
         emit connectionReset();
-    } else if (msg.pathPart(0) == "event" && msg.pathPart(1) == "state") {
+    });
+    m_router.addRoute("event/state/...", this, [this](const EosOSCMessage& msg) {
         setLive(msg.numericValue() != 0.0);
-    } else if (msg.pathPart(0) == "ping") {
+    });
+    m_router.addRoute("ping/...", this, [this](const EosOSCMessage& msg) {
         if (msg.arguments().size() == 2) {
             if (msg.arguments()[0] != m_instanceId) {
                 // this is a ping message meant for a different instance
                 return;
             }
-            onPingReceived(msg.arguments()[1].toInt());
+            onPingReceived(msg.arguments()[1].toLongLong());
         }
-    } else if (msg.pathPart(0) == "get" && msg.pathPart(1) == "version") {
+    });
+    m_router.addRoute("get/version/...", this, [this](const EosOSCMessage& msg) {
         setConsoleVersion(msg.stringValue());
-    } else if (msg.pathPart(0) == "active" && msg.pathPart(1) == "cue") {
+    });
+    m_router.addRoute("active/cue/...", this, [this](const EosOSCMessage& msg) {
         if (msg.pathPart(2) == "text") {
             // this message contains a descriptive text for the active cue:
             m_activeCueDescription = msg.stringValue();
@@ -138,7 +166,8 @@ void EosOSCManager::onIncomingEosMessage(const EosOSCMessage& msg) {
             m_activeCuePercentComplete = msg.numericValue();
             emit cueInfoChanged();
         }
-    } else if (msg.pathPart(0) == "pending" && msg.pathPart(1) == "cue") {
+    });
+    m_router.addRoute("pending/cue/...", this, [this](const EosOSCMessage& msg) {
         if (msg.pathPart(2) == "text") {
             // this message contains a descriptive text for the active cue:
             m_pendingCueDescription = msg.stringValue();
@@ -155,10 +184,7 @@ void EosOSCManager::onIncomingEosMessage(const EosOSCMessage& msg) {
             m_pendingCueNumbers[pendingCue.list] = pendingCue;
             emit cueInfoChanged();
         }
-    } else {
-        // emit signal, let specific Blocks handle this message:
-        emit eosMessageReceived(msg);
-    }
+    });
 }
 
 void EosOSCManager::onConnectionChanged() {
@@ -180,10 +206,10 @@ void EosOSCManager::updateLatency() {
     if (m_controller->lightingConsole()->isConnected()
             && m_controller->lightingConsole()->getCurrentType() == OscConnectionType::Eos) {
         // it is, check latency:
-        // calculate current time stamp (milliseconds since program start):
-        // (possible overflow with int32 at around 600h runtime)
-        long timestamp = long(HighResTime::elapsedSecSince(m_startTime) * 1000);
-        // send ping with current time stamp:
+        // current time stamp in µs, the console sends it back unchanged:
+        qint64 timestamp = OSCConnectionTelemetry::nowMicroseconds();
+        // send ping with current time stamp,
+        // sendMessage() doesn't wait for the end of the frame, so only the link is measured:
         m_controller->lightingConsole()->sendMessage("/eos/ping", m_instanceId, QString::number(timestamp));
         // start timeout timer:
         m_latencyTimeout.start();
@@ -194,14 +220,16 @@ void EosOSCManager::updateLatency() {
     }
 }
 
-void EosOSCManager::onPingReceived(int timestamp) {
+void EosOSCManager::onPingReceived(qint64 timestamp) {
     // cancel latency timeout:
     m_latencyTimeout.stop();
     m_timeouts = 0;
-    // calculate current time stamp (milliseconds since program start):
-    long now = long(HighResTime::elapsedSecSince(m_startTime) * 1000);
+    // round trip time in µs:
+    qint64 roundTripTime = OSCConnectionTelemetry::nowMicroseconds() - timestamp;
+    if (roundTripTime < 0) return;
+    m_controller->lightingConsole()->telemetry()->addRoundTripTime(roundTripTime);
     // update latency value:
-    setLatency(int(now - timestamp));
+    setLatency(int(roundTripTime / 1000));
 }
 
 void EosOSCManager::onLatencyTimeout() {
@@ -2,6 +2,7 @@
 #define EOSCONSOLE_H
 
 #include "eos_specific/EosOSCMessage.h"
+#include "eos_specific/EosMessageRouter.h"
 #include "osc/OSCMessage.h"
 #include "EosCue.h"
 #include "OSCDiscovery.h"
@@ -11,6 +12,7 @@
 #include <QTimer>
 #include <QDebug>
 #include <QJsonArray>
+#include <QHash>
 
 // forward declaration to prevent dependency loop
 class MainController;
@@ -28,6 +30,10 @@ namespace EosOSCManagerConstants {
      * @brief latencyTimeout the time until a timout in the connection occures in ms
      */
     static const int latencyTimeout = 1500;  // in ms
+    /**
+     * @brief maxIncompleteMessages the maximum count of List Convention messages being reassembled
+     */
+    static const int maxIncompleteMessages = 64;
 }
 
 
@@ -59,9 +65,16 @@ public:
     virtual void OSCDiscoveryClientClient_Log(const QString &) override {}
     virtual void OSCDiscoveryClientClient_Found(const OSCDiscoveryClient::sDiscoveryServer& server) override;
 
+    /**
+     * @brief router returns the router to register handlers for specific Eos message paths
+     * @return the router of complete incoming Eos messages
+     */
+    EosMessageRouter* router() { return &m_router; }
+
 signals:
     /**
      * @brief eosMessageReceived is emitted when a valid Eos OSC message was received
+     * that doesn't match any route of the router
      * @param msg the received message
      */
     void eosMessageReceived(EosOSCMessage msg);
@@ -132,9 +145,9 @@ public slots:
     void updateLatency();
     /**
      * @brief onPingReceived handles a connection latency ping from the console
-     * @param timestamp the timestamp in the message
+     * @param timestamp the timestamp in the message in µs
      */
-    void onPingReceived(int timestamp);
+    void onPingReceived(qint64 timestamp);
     /**
      * @brief onLatencyTimeout handles a latency check timeout
      */
@@ -259,9 +272,14 @@ public slots:
     QJsonArray getDiscoveredConsoles() const { return m_discoveredConsoles; }
 
 protected:
+    /**
+     * @brief addMessageRoutes registers the handlers of general information messages
+     */
+    void addMessageRoutes();
+
     MainController* const m_controller;  //!< a pointer to the MainController
 
-    QVariant m_incompleteMessage;  //!< incomplete message (of type EosOSCMessage)
+    QHash<QString, EosOSCMessage> m_incompleteMessages;  //!< incomplete List Convention messages by path
 
     int m_oscUserId;  //!< Eos OSC user id
     QString m_showTitle;  //!< current show title
@@ -276,7 +294,6 @@ protected:
 
     QTimer m_latencyCheckTimer;  //!< timer to check latency periodically
     QTimer m_latencyTimeout;  //!< timer to detect connection timeout
-    HighResTime::time_point_t m_startTime;  //!< start time used for timestamps
     int m_latency;  //!< connection latency in ms
     const QString m_instanceId;  //!< random instance id to not get confused by messages from other luminosus instances
 
@@ -288,6 +305,8 @@ protected:
 
     OSCDiscoveryClient m_discoveryClient;
     QJsonArray m_discoveredConsoles;
+
+    EosMessageRouter m_router;  //!< dispatches complete Eos messages to the handlers of their path
 };
 
 #endif // EOSCONSOLE_H
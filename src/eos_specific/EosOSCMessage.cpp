@@ -2,6 +2,10 @@
 
 #include <QDebug>
 
+// maximum argument count of an OSC List Convention message,
+// the largest messages from Eos (i.e. cues) have less than 100 arguments:
+static const int MAX_LIST_CONVENTION_ARGUMENTS = 4096;
+
 EosOSCMessage::EosOSCMessage()
     : m_userId(-1)
     , m_listConventionArgumentCount(0)
@@ -38,7 +42,17 @@ EosOSCMessage::EosOSCMessage(const OSCMessage& msg)
     // they end with ".../list/<index>/<count>"
     if (pathPart(-3) == "list") {
         // get total argument count:
-        m_listConventionArgumentCount = pathPart(-1).toInt();
+        const int argumentCount = pathPart(-1).toInt();
+        if (argumentCount < m_arguments.size() || argumentCount > MAX_LIST_CONVENTION_ARGUMENTS) {
+            // the count comes from the network, don't trust it:
+            qWarning() << "Discarded OSC List Convention message with invalid argument count.";
+            m_path.clear();
+            m_arguments.clear();
+            return;
+        }
+        m_listConventionArgumentCount = argumentCount;
+        // the following parts are appended in place:
+        m_arguments.reserve(m_listConventionArgumentCount);
         // remove the last three path parts:
         m_path.pop_back();
         m_path.pop_back();
@@ -46,12 +60,39 @@ EosOSCMessage::EosOSCMessage(const OSCMessage& msg)
     }
 }
 
-bool EosOSCMessage::add(const OSCMessage& msg) {
-    if (msg.pathPart(-1).toInt() != m_arguments.size()) {
+EosOSCMessage::EosOSCMessage(const QStringList& path, const QVector<QVariant>& arguments)
+    : m_path(path)
+    , m_arguments(arguments)
+    , m_userId(-1)
+    , m_listConventionArgumentCount(0)
+{
+
+}
+
+bool EosOSCMessage::add(int listIndex, const QVector<QVariant>& arguments) {
+    if (listIndex != m_arguments.size()
+            || m_arguments.size() + arguments.size() > m_listConventionArgumentCount) {
         qWarning() << "OSC List Convention argument index doesn't fit.";
         return false;
     }
-    m_arguments.append(msg.arguments());
+    m_arguments += arguments;
+    return true;
+}
+
+bool EosOSCMessage::parseListConvention(const QString& path, int& baseLength, int& listIndex, int& listCount) {
+    const int countStart = path.lastIndexOf('/');
+    if (countStart <= 0) return false;
+    const int indexStart = path.lastIndexOf('/', countStart - 1);
+    if (indexStart <= 0) return false;
+    const int listStart = path.lastIndexOf('/', indexStart - 1);
+    if (listStart < 0) return false;
+    if (path.midRef(listStart + 1, indexStart - listStart - 1) != QLatin1String("list")) return false;
+    bool indexOk = false;
+    bool countOk = false;
+    listIndex = path.midRef(indexStart + 1, countStart - indexStart - 1).toInt(&indexOk);
+    listCount = path.midRef(countStart + 1).toInt(&countOk);
+    if (!indexOk || !countOk) return false;
+    baseLength = listStart;
     return true;
 }
 
@@ -85,3 +126,16 @@ QString EosOSCMessage::stringValue() const {
     if (m_arguments.first().type() == QVariant::String) return m_arguments.first().toString();
     return "";
 }
+
+QDataStream& operator<<(QDataStream& out, const EosOSCMessage& msg) {
+    out << msg.path() << msg.arguments();
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, EosOSCMessage& msg) {
+    QStringList path;
+    QVector<QVariant> arguments;
+    in >> path >> arguments;
+    msg = EosOSCMessage(path, arguments);
+    return in;
+}
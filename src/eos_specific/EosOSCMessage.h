@@ -27,6 +27,7 @@
 #include <QVector>
 #include <QVariant>
 #include <QByteArray>
+#include <QDataStream>
 
 
 /**
@@ -49,11 +50,31 @@ public:
     explicit EosOSCMessage(const OSCMessage& msg);
 
     /**
-     * @brief add tries to complete an uncomplete OSC List Convention message with another message
-     * @param msg possible part of OSC List Convention message
-     * @return true if message could be appended
+     * @brief EosOSCMessage creates a complete message from an already prepared path and arguments,
+     * i.e. when it is restored from a cache
+     * @param path path without "/eos/out" and user part
+     * @param arguments the arguments of the message
      */
-    bool add(const OSCMessage& msg);
+    EosOSCMessage(const QStringList& path, const QVector<QVariant>& arguments);
+
+    /**
+     * @brief add appends the arguments of the next part of an uncomplete OSC List Convention message
+     * @param listIndex index of the first argument in this part (from the path of the part)
+     * @param arguments the arguments of the part
+     * @return true if the arguments could be appended
+     */
+    bool add(int listIndex, const QVector<QVariant>& arguments);
+
+    /**
+     * @brief parseListConvention checks if a path ends with ".../list/<index>/<count>"
+     * without splitting it
+     * @param path complete OSC path
+     * @param baseLength is set to the length of the path without the list part
+     * @param listIndex is set to the index of the first argument in this part
+     * @param listCount is set to the argument count of the complete message
+     * @return true if this is a OSC List Convention path
+     */
+    static bool parseListConvention(const QString& path, int& baseLength, int& listIndex, int& listCount);
 
     /**
      * @brief path returns the path as a list of strings
@@ -131,6 +152,15 @@ protected:
     int m_listConventionArgumentCount;
 };
 
+/**
+ * @brief operator << writes the path and arguments of a complete message to a data stream
+ */
+QDataStream& operator<<(QDataStream& out, const EosOSCMessage& msg);
+/**
+ * @brief operator >> reads a message written with operator <<
+ */
+QDataStream& operator>>(QDataStream& in, EosOSCMessage& msg);
+
 // register this class to the Qt MetaType system to be able to use it i.e. in QVariant:
 Q_DECLARE_METATYPE(EosOSCMessage)
 
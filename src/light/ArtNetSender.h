@@ -6,26 +6,49 @@
 #include <QVector>
 #include <QObject>
 
+#include "UdpBatchSender.h"
+
 
 class ArtNetSubnetSender
 {
 
 public:
-    ArtNetSubnetSender(int net, int subnet);
+    /**
+     * @brief ArtNetSubnetSender creates an Art-Net sender
+     * @param net Art-Net net of the first universe
+     * @param subnet Art-Net subnet of the first universe
+     * @param udpSender sender the datagrams are written to, has to outlive this object
+     */
+    ArtNetSubnetSender(int net, int subnet, UdpBatchSender* udpSender);
 
     void setNetAndSubnet(int net, int subnet);
 
+    /**
+     * @brief sendUniverseBroadcast sends the DMX data of a universe as broadcast
+     * @param universe index of the universe relative to the first universe of the net and subnet,
+     * values above 15 continue in the following subnets
+     * @param data 512 bytes of DMX data
+     */
     void sendUniverseBroadcast(int universe, const QVector<uint8_t>& data);
 
     void sendUniverseUnicast(int universe, const QVector<uint8_t>& data, const QVector<QHostAddress>& addresses);
 
+    /**
+     * @brief getMaxUniverseCount returns the number of universes that can be addressed
+     * starting from the current net and subnet
+     * @return number of universes
+     */
+    int getMaxUniverseCount() const;
+
 private:
-    void preparePackets(int net, int subnet);
+    QVector<uint8_t>& getPreparedPacket(int universe);
+    void preparePacket(int universe);
 
 protected:
-    uint8_t m_sequenceNumber;
-    QVector<QVector<uint8_t>> m_preparedPackets;
-    QUdpSocket m_udpSocket;
+    int m_net;
+    int m_subnet;
+    QVector<QVector<uint8_t>> m_preparedPackets;  //!< created on demand, sequence number is stored per packet
+    UdpBatchSender* const m_udpSender;  //!< shared with the other senders, not owned
 };
 
 #endif // ARTNETSENDER_H
@@ -5,6 +5,8 @@
 #include <QUdpSocket>
 #include <QVector>
 #include <QObject>
+
+#include "UdpBatchSender.h"
 #include <QUuid>
 
 
@@ -12,24 +14,42 @@ class SAcnSender
 {
 
 public:
-    SAcnSender(int startUniverse = 1, int priority = 100);
+    /**
+     * @brief SAcnSender creates an sACN sender
+     * @param startUniverse sACN universe of the first universe
+     * @param priority sACN priority of the packets
+     * @param udpSender sender the datagrams are written to, has to outlive this object
+     */
+    SAcnSender(int startUniverse, int priority, UdpBatchSender* udpSender);
 
     void setStartUniverse(int startUniverse);
 
     void setPriority(int priority);
 
+    /**
+     * @brief sendUniverseMulticast sends the DMX data of a universe to its multicast address
+     * @param universe index of the universe relative to the start universe
+     * @param data 512 bytes of DMX data
+     */
     void sendUniverseMulticast(int universe, const QVector<uint8_t>& data);
 
     void sendUniverseUnicast(int universe, const QVector<uint8_t>& data, const QVector<QHostAddress>& addresses);
 
+    /**
+     * @brief getMaxUniverseCount returns the number of universes that can be addressed
+     * starting from the start universe
+     * @return number of universes
+     */
+    int getMaxUniverseCount() const;
+
 private:
-    void preparePackets();
+    QVector<uint8_t>& getPreparedPacket(int universe);
+    void preparePacket(int universe);
 
 protected:
-    uint8_t m_sequenceNumber;
-    QVector<QVector<uint8_t>> m_preparedPackets;
+    QVector<QVector<uint8_t>> m_preparedPackets;  //!< created on demand, sequence number is stored per packet
     QVector<QHostAddress> m_multicastAddresses;
-    QUdpSocket m_udpSocket;
+    UdpBatchSender* const m_udpSender;  //!< shared with the other senders, not owned
     int m_startUniverse;
     int m_priority;
     QUuid m_uuid;
@@ -0,0 +1,216 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "DmxOutputWorker.h"
+
+#include "ArtNetSender.h"
+#include "BasicSAcnSender.h"
+#include "UdpBatchSender.h"
+
+#include <QTimer>
+#include <QMutexLocker>
+#include <QDebug>
+
+
+DmxOutputWorker::DmxOutputWorker()
+    : QObject(nullptr)
+    , m_mutex()
+    , m_pendingUniverses()
+    , m_pendingSettings()
+    , m_settingsChanged(false)
+    , m_sendScheduled(false)
+    , m_framePaced(false)
+    , m_sentPacketCount(0)
+    , m_syscallsPerFrame(0)
+    , m_settings()
+    , m_udpSender(nullptr)
+    , m_artnet(nullptr)
+    , m_sAcnSender(nullptr)
+    , m_artnetUnicastAddresses()
+    , m_keepAliveTimer(nullptr)
+    , m_clock()
+    , m_universes()
+{
+
+}
+
+DmxOutputWorker::~DmxOutputWorker() {
+    // the worker is deleted in the network thread, so are the sockets:
+    delete m_artnet;
+    delete m_sAcnSender;
+    delete m_udpSender;
+}
+
+void DmxOutputWorker::submitUniverses(const QVector<QPair<int, QVector<uint8_t>>>& universes) {
+    if (universes.isEmpty()) return;
+    QMutexLocker locker(&m_mutex);
+    for (const QPair<int, QVector<uint8_t>>& universe: universes) {
+        // if the network thread is behind, only the latest data of a universe is sent:
+        m_pendingUniverses[universe.first] = universe.second;
+    }
+    if (!m_framePaced) scheduleSend();
+}
+
+void DmxOutputWorker::setSettings(const DmxOutputSettings& settings) {
+    QMutexLocker locker(&m_mutex);
+    m_pendingSettings = settings;
+    m_settingsChanged = true;
+    scheduleSend();
+}
+
+void DmxOutputWorker::onOutputFrameDue() {
+    // this is called in the frame clock thread:
+    if (!m_framePaced) return;
+    QMutexLocker locker(&m_mutex);
+    if (m_pendingUniverses.isEmpty()) return;
+    scheduleSend();
+}
+
+void DmxOutputWorker::scheduleSend() {
+    if (m_sendScheduled) return;
+    m_sendScheduled = true;
+    QMetaObject::invokeMethod(this, "sendPendingUniverses", Qt::QueuedConnection);
+}
+
+void DmxOutputWorker::init() {
+    // sockets have to be created in the thread they are used in:
+    // both protocols write to the same socket, so that a frame is sent in one batch:
+    m_udpSender = new UdpBatchSender();
+    m_artnet = new ArtNetSubnetSender(m_settings.artnetNet, m_settings.artnetSubnet, m_udpSender);
+    m_sAcnSender = new SAcnSender(m_settings.sAcnStartUniverse, m_settings.sAcnPriority, m_udpSender);
+
+    m_clock.start();
+
+    m_keepAliveTimer = new QTimer(this);
+    m_keepAliveTimer->setInterval(DmxOutputConstants::keepAliveCheckInterval);
+    connect(m_keepAliveTimer, SIGNAL(timeout()), this, SLOT(sendKeepAlive()));
+    m_keepAliveTimer->start();
+}
+
+void DmxOutputWorker::sendPendingUniverses() {
+    if (!m_artnet || !m_sAcnSender) init();
+
+    QHash<int, QVector<uint8_t>> pendingUniverses;
+    DmxOutputSettings settings;
+    bool settingsChanged = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        pendingUniverses.swap(m_pendingUniverses);
+        settings = m_pendingSettings;
+        settingsChanged = m_settingsChanged;
+        m_settingsChanged = false;
+        m_sendScheduled = false;
+    }
+
+    if (settingsChanged) {
+        applySettings(settings);
+    }
+
+    const qint64 now = m_clock.elapsed();
+    // all datagrams of this frame are sent together:
+    beginBatch();
+    for (auto it = pendingUniverses.constBegin(); it != pendingUniverses.constEnd(); ++it) {
+        UniverseState& state = m_universes[it.key()];
+        state.current = it.value();
+        sendIfChanged(it.key(), state, now);
+    }
+
+    if (settingsChanged) {
+        // all universes have to be sent again with the new settings:
+        for (auto it = m_universes.begin(); it != m_universes.end(); ++it) {
+            sendIfChanged(it.key(), it.value(), now);
+        }
+    }
+    m_syscallsPerFrame = flushBatch();
+}
+
+void DmxOutputWorker::sendKeepAlive() {
+    if (!m_artnet || !m_sAcnSender) return;
+    const qint64 now = m_clock.elapsed();
+    beginBatch();
+    for (auto it = m_universes.begin(); it != m_universes.end(); ++it) {
+        UniverseState& state = it.value();
+        if (state.lastSent.isEmpty()) continue;
+        if (m_settings.sAcnEnabled
+                && now - state.lastSAcnSendTime >= DmxOutputConstants::sAcnKeepAliveInterval) {
+            sendSAcn(it.key(), state, now);
+        }
+        if (m_settings.artnetEnabled
+                && now - state.lastArtnetSendTime >= DmxOutputConstants::artnetKeepAliveInterval) {
+            sendArtnet(it.key(), state, now);
+        }
+    }
+    flushBatch();
+}
+
+void DmxOutputWorker::beginBatch() {
+    m_udpSender->beginBatch();
+}
+
+int DmxOutputWorker::flushBatch() {
+    const quint64 syscallsBefore = m_udpSender->getSyscallCount();
+    m_udpSender->flush();
+    return int(m_udpSender->getSyscallCount() - syscallsBefore);
+}
+
+void DmxOutputWorker::applySettings(const DmxOutputSettings& settings) {
+    if (settings.artnetNet != m_settings.artnetNet || settings.artnetSubnet != m_settings.artnetSubnet) {
+        m_artnet->setNetAndSubnet(settings.artnetNet, settings.artnetSubnet);
+    }
+    if (settings.sAcnStartUniverse != m_settings.sAcnStartUniverse) {
+        m_sAcnSender->setStartUniverse(settings.sAcnStartUniverse);
+    }
+    if (settings.sAcnPriority != m_settings.sAcnPriority) {
+        m_sAcnSender->setPriority(settings.sAcnPriority);
+    }
+    m_settings = settings;
+
+    // forget what was sent, so that everything is sent again:
+    for (UniverseState& state: m_universes) {
+        state.lastSent.clear();
+    }
+}
+
+void DmxOutputWorker::sendIfChanged(int universe, UniverseState& state, qint64 now) {
+    if (!m_settings.sAcnEnabled && !m_settings.artnetEnabled) return;
+    if (state.current == state.lastSent) return;
+    state.lastSent = state.current;
+    if (m_settings.sAcnEnabled) sendSAcn(universe, state, now);
+    if (m_settings.artnetEnabled) sendArtnet(universe, state, now);
+}
+
+void DmxOutputWorker::sendSAcn(int universe, UniverseState& state, qint64 now) {
+    if (universe >= m_sAcnSender->getMaxUniverseCount()) return;
+    m_sAcnSender->sendUniverseMulticast(universe, state.lastSent);
+    state.lastSAcnSendTime = now;
+    ++m_sentPacketCount;
+}
+
+void DmxOutputWorker::sendArtnet(int universe, UniverseState& state, qint64 now) {
+    if (universe >= m_artnet->getMaxUniverseCount()) return;
+    // unicast needs discovered nodes, without any known node the universe is broadcasted:
+    if (m_settings.broadcastArtnet || m_artnetUnicastAddresses.isEmpty()) {
+        m_artnet->sendUniverseBroadcast(universe, state.lastSent);
+    } else {
+        m_artnet->sendUniverseUnicast(universe, state.lastSent, m_artnetUnicastAddresses);
+    }
+    state.lastArtnetSendTime = now;
+    ++m_sentPacketCount;
+}
@@ -0,0 +1,199 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DMXOUTPUTWORKER_H
+#define DMXOUTPUTWORKER_H
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QHostAddress>
+
+#include <atomic>
+#include <cstdint>
+
+// forward declarations:
+class ArtNetSubnetSender;
+class SAcnSender;
+class UdpBatchSender;
+class QTimer;
+
+
+namespace DmxOutputConstants {
+    // interval to check if a keep-alive packet has to be sent:
+    static const int keepAliveCheckInterval = 100;  // in ms
+    // E1.31 requires a packet at least every second (same as SEND_INTERVAL_DMX in sacn/sacnsender.h):
+    static const int sAcnKeepAliveInterval = 850;  // in ms
+    // Art-Net nodes expect a refresh at least every 4s, many time out earlier:
+    static const int artnetKeepAliveInterval = 1000;  // in ms
+}
+
+
+/**
+ * @brief The DmxOutputSettings struct contains the protocol settings of the OutputManager
+ * that are needed to send the universes.
+ */
+struct DmxOutputSettings {
+    bool sAcnEnabled = false;
+    bool artnetEnabled = false;
+    bool broadcastArtnet = false;
+    int sAcnStartUniverse = 1;
+    int sAcnPriority = 100;
+    int artnetNet = 0;
+    int artnetSubnet = 0;
+};
+
+
+/**
+ * @brief The DmxOutputWorker class sends the DMX universes via Art-Net and sACN.
+ *
+ * It lives in its own network thread, so that socket writes never block the engine.
+ * The OutputManager submits the changed universes each frame, a universe is only sent
+ * if its bytes differ from the last sent ones. Unchanged universes are repeated
+ * in the keep-alive intervals required by the protocols.
+ *
+ * In frame paced mode (the realtime mode of the Engine) the submitted universes are sent
+ * when onOutputFrameDue() is called by the frame clock thread, so that the output timing
+ * doesn't depend on the main thread.
+ */
+class DmxOutputWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    DmxOutputWorker();
+    ~DmxOutputWorker();
+
+    // ---- thread-safe methods to be called from the OutputManager:
+
+    /**
+     * @brief submitUniverses hands the data of changed universes over to the network thread
+     * @param universes list of universe indexes and their 512 channels
+     */
+    void submitUniverses(const QVector<QPair<int, QVector<uint8_t>>>& universes);
+
+    /**
+     * @brief setSettings changes the protocol settings, all universes are sent again afterwards
+     * @param settings new settings
+     */
+    void setSettings(const DmxOutputSettings& settings);
+
+    /**
+     * @brief setFramePaced sets if submitted universes are sent immediately (false)
+     * or with the next onOutputFrameDue() call (true)
+     * @param value true to send with the frame clock
+     */
+    void setFramePaced(bool value) { m_framePaced = value; }
+
+    /**
+     * @brief getSentPacketCount returns the number of packets sent since the start
+     * @return number of packets
+     */
+    quint64 getSentPacketCount() const { return m_sentPacketCount; }
+
+    /**
+     * @brief getSyscallsPerFrame returns the number of send syscalls that were needed
+     * for the last frame with changed universes
+     * @return number of syscalls
+     */
+    int getSyscallsPerFrame() const { return m_syscallsPerFrame; }
+
+public slots:
+    // ---- to be called only in the network thread:
+
+    /**
+     * @brief init creates the sockets and timers in the network thread,
+     * has to be connected to QThread::started()
+     */
+    void init();
+
+    /**
+     * @brief sendPendingUniverses sends the submitted universes that changed
+     */
+    void sendPendingUniverses();
+
+    /**
+     * @brief sendKeepAlive repeats universes that were not sent within the keep-alive interval
+     */
+    void sendKeepAlive();
+
+    /**
+     * @brief onOutputFrameDue sends the submitted universes in frame paced mode,
+     * thread-safe, to be connected to Engine::outputFrameDue() with a direct connection
+     */
+    void onOutputFrameDue();
+
+protected:
+    struct UniverseState {
+        QVector<uint8_t> current;  //!< last submitted data
+        QVector<uint8_t> lastSent;  //!< empty if not sent yet (or to be sent again)
+        qint64 lastSAcnSendTime = 0;  //!< in ms since m_clock start
+        qint64 lastArtnetSendTime = 0;  //!< in ms since m_clock start
+    };
+
+    /**
+     * @brief beginBatch collects the datagrams of both senders until flushBatch() is called,
+     * they share one UdpBatchSender, so that a frame needs only one batch
+     */
+    void beginBatch();
+    /**
+     * @brief scheduleSend queues a call of sendPendingUniverses() in the network thread,
+     * m_mutex has to be locked
+     */
+    void scheduleSend();
+    /**
+     * @brief flushBatch sends the collected datagrams
+     * @return number of syscalls needed to send them
+     */
+    int flushBatch();
+
+    void applySettings(const DmxOutputSettings& settings);
+    void sendIfChanged(int universe, UniverseState& state, qint64 now);
+    void sendSAcn(int universe, UniverseState& state, qint64 now);
+    void sendArtnet(int universe, UniverseState& state, qint64 now);
+
+    // ---- shared between threads, protected by m_mutex:
+
+    QMutex m_mutex;
+    QHash<int, QVector<uint8_t>> m_pendingUniverses;  //!< last submitted data per universe
+    DmxOutputSettings m_pendingSettings;
+    bool m_settingsChanged;
+    bool m_sendScheduled;  //!< true if sendPendingUniverses() is already queued
+
+    std::atomic<bool> m_framePaced;  //!< true if universes are sent in onOutputFrameDue()
+    std::atomic<quint64> m_sentPacketCount;
+    std::atomic<int> m_syscallsPerFrame;
+
+    // ---- only used in network thread:
+
+    DmxOutputSettings m_settings;
+    UdpBatchSender* m_udpSender;  //!< socket shared by the Art-Net and sACN sender
+    ArtNetSubnetSender* m_artnet;
+    SAcnSender* m_sAcnSender;
+    QVector<QHostAddress> m_artnetUnicastAddresses;
+    QTimer* m_keepAliveTimer;
+    QElapsedTimer m_clock;
+    QHash<int, UniverseState> m_universes;
+};
+
+#endif // DMXOUTPUTWORKER_H
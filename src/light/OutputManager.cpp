@@ -27,6 +27,7 @@
 
 OutputManager::OutputManager(MainController* controller)
     : QObject(controller)
+    , m_controller(controller)
     , m_sAcnEnabled(false)
     , m_artnetEnabled(false)
     , m_sAcnStartUniverse(1)
@@ -34,20 +35,38 @@ OutputManager::OutputManager(MainController* controller)
     , m_artnetNet(0)
     , m_artnetSubnet(0)
     , m_broadcastArtnet(false)
-    , m_artnet(m_artnetNet, m_artnetSubnet)
     //, m_artnetDiscoveryManager()
-    , m_sAcnSender(m_sAcnStartUniverse, 100)
-    , m_universes(16, QVector<uint8_t>(512, 0))
+    , m_networkThread()
+    , m_outputWorker(new DmxOutputWorker())
+    , m_universes()
+    , m_universeDirty()
+    , m_dirtyUniverses()
     , m_usedAddressCount(0)
     , m_nextAddressToUse(1)
 {
-    for (int i=0; i<16; ++i) {
-        m_universeDirty[i] = false;
-    }
+    // the worker is deleted in its own thread when the thread finishes:
+    m_outputWorker->moveToThread(&m_networkThread);
+    connect(&m_networkThread, SIGNAL(started()), m_outputWorker, SLOT(init()));
+    connect(&m_networkThread, SIGNAL(finished()), m_outputWorker, SLOT(deleteLater()));
+    m_networkThread.setObjectName("DmxOutput");
+    m_networkThread.start(QThread::HighPriority);
+    updateWorkerSettings();
+
     connect(controller->engine(), SIGNAL(updateOutput(double)), this, SLOT(triggerOutput()));
+    // in realtime mode the universes are sent from the frame clock thread,
+    // independent of the main thread:
+    connect(controller->engine(), SIGNAL(outputFrameDue(double)),
+            m_outputWorker, SLOT(onOutputFrameDue()), Qt::DirectConnection);
+    connect(controller->engine(), SIGNAL(realtimeModeChanged()), this, SLOT(updateFramePacing()));
+    updateFramePacing();
     //connect(&m_artnetDiscoveryManager, SIGNAL(discoveredNodesChanged()), this, SIGNAL(discoveredNodesChanged()));
 }
 
+OutputManager::~OutputManager() {
+    m_networkThread.quit();
+    m_networkThread.wait();
+}
+
 QJsonObject OutputManager::getState() const {
     QJsonObject state;
     state["sAcnEnabled"] = getSAcnEnabled();
@@ -74,35 +93,71 @@ void OutputManager::setState(const QJsonObject& state) {
 }
 
 void OutputManager::setChannel(int address, double value) {
-    if (address > 8192 || address < 1) return;
+    if (address > OutputManagerConstants::maxAddress || address < 1) return;
     --address; // DMX channel 1 is index 0 in array
-    unsigned int universe = static_cast<unsigned int>(address) / 512; // integer division
-    m_universes[universe][static_cast<unsigned int>(address % 512)] = uint8_t(value * 255);
-    m_universeDirty[universe] = true;
+    setChannelInUniverse(address / OutputManagerConstants::channelsPerUniverse,  // integer division
+                         address % OutputManagerConstants::channelsPerUniverse + 1,
+                         value);
 }
 
-void OutputManager::triggerOutput() {
-    for (int universe = 0; universe < 16; ++universe) {
-        if (m_universeDirty[universe]) {
-            if (m_artnetEnabled) {
-                if (m_broadcastArtnet) {
-                    //m_artnet.sendUniverseBroadcast(universe, m_universes[universe]);
-                } else {
-                    //m_artnet.sendUniverseUnicast(universe, m_universes[universe], m_artnetDiscoveryManager.getUnicastAddresses());
-                }
-            }
-            if (m_sAcnEnabled) {
-                //m_sAcnSender.sendUniverseMulticast(universe, m_universes[universe]);
-            }
-            m_universeDirty[universe] = false;
+void OutputManager::setChannelInUniverse(int universe, int channel, double value) {
+    if (universe < 0 || universe >= OutputManagerConstants::maxUniverseCount) return;
+    if (channel < 1 || channel > OutputManagerConstants::channelsPerUniverse) return;
+    uint8_t& currentValue = getUniverse(universe)[channel - 1];
+    const uint8_t newValue = uint8_t(value * 255);
+    if (newValue == currentValue) return;
+    currentValue = newValue;
+    if (!m_universeDirty[universe]) {
+        m_universeDirty[universe] = true;
+        m_dirtyUniverses.append(universe);
+    }
+}
+
+bool OutputManager::universeExists(int universe) const {
+    if (universe < 0 || universe >= m_universes.size()) return false;
+    return !m_universes[universe].isEmpty();
+}
+
+QVector<uint8_t>& OutputManager::getUniverse(int universe) {
+    if (universe >= m_universes.size()) {
+        m_universes.resize(universe + 1);
+        m_universeDirty.resize(universe + 1);
+    }
+    QVector<uint8_t>& data = m_universes[universe];
+    if (data.isEmpty()) {
+        data.fill(0, OutputManagerConstants::channelsPerUniverse);
+        // a new universe is sent in its first frame, even if all its channels stay at zero:
+        if (!m_universeDirty[universe]) {
+            m_universeDirty[universe] = true;
+            m_dirtyUniverses.append(universe);
         }
     }
+    return data;
+}
+
+void OutputManager::updateFramePacing() {
+    m_outputWorker->setFramePaced(m_controller->engine()->getRealtimeMode());
+}
+
+void OutputManager::triggerOutput() {
+    if (m_dirtyUniverses.isEmpty()) return;
+    // only universes that changed since the last output are touched,
+    // the data is implicitly shared and only copied when it is modified in the next frame:
+    QVector<QPair<int, QVector<uint8_t>>> changedUniverses;
+    changedUniverses.reserve(m_dirtyUniverses.size());
+    for (int universe: m_dirtyUniverses) {
+        changedUniverses.append(qMakePair(universe, m_universes[universe]));
+        m_universeDirty[universe] = false;
+    }
+    m_dirtyUniverses.clear();
+    // the network thread compares them with the last sent data and sends them:
+    m_outputWorker->submitUniverses(changedUniverses);
 }
 
 int OutputManager::getUnusedAddress(int footprint) {
     int address = m_nextAddressToUse + m_usedAddressCount;
-    if (address > 8192) {
-        address %= 8192;
+    if (address > OutputManagerConstants::maxAddress) {
+        address = (address - 1) % OutputManagerConstants::maxAddress + 1;
     }
     m_usedAddressCount += footprint;
     return address;
@@ -114,29 +169,41 @@ void OutputManager::setNextAddressToUse(int address) {
 }
 
 void OutputManager::setSAcnStartUniverse(int value) {
-    m_sAcnStartUniverse = limit(1, value, 63999 - 16);
-    m_sAcnSender.setStartUniverse(m_sAcnStartUniverse);
+    m_sAcnStartUniverse = limit(1, value, 63999);
+    updateWorkerSettings();
     emit sAcnStartUniverseChanged();
 }
 
 void OutputManager::setSAcnPriority(int value) {
     m_sAcnPriority = limit(1, value, 200);
-    m_sAcnSender.setPriority(m_sAcnPriority);
+    updateWorkerSettings();
     emit sAcnPriorityChanged();
 }
 
 void OutputManager::setArtnetNet(int value) {
     m_artnetNet = limit(0, value, 127);
-    m_artnet.setNetAndSubnet(m_artnetNet, m_artnetSubnet);
+    updateWorkerSettings();
     emit artnetNetChanged();
 }
 
 void OutputManager::setArtnetSubnet(int value) {
     m_artnetSubnet = limit(0, value, 15);
-    m_artnet.setNetAndSubnet(m_artnetNet, m_artnetSubnet);
+    updateWorkerSettings();
     emit artnetSubnetChanged();
 }
 
+void OutputManager::updateWorkerSettings() {
+    DmxOutputSettings settings;
+    settings.sAcnEnabled = m_sAcnEnabled;
+    settings.artnetEnabled = m_artnetEnabled;
+    settings.broadcastArtnet = m_broadcastArtnet;
+    settings.sAcnStartUniverse = m_sAcnStartUniverse;
+    settings.sAcnPriority = m_sAcnPriority;
+    settings.artnetNet = m_artnetNet;
+    settings.artnetSubnet = m_artnetSubnet;
+    m_outputWorker->setSettings(settings);
+}
+
 QVariantList OutputManager::getDiscoveredNodes() {
     //return m_artnetDiscoveryManager.getDiscoveredNodes();
     return QVariantList();
@@ -23,18 +23,26 @@
 
 #include <QObject>
 #include <QVector>
+#include <QThread>
 
 #include <cstdint>
 
 #include "ArtNetDiscoveryManager.h"
-#include "ArtNetSender.h"
-#include "BasicSAcnSender.h"
+#include "DmxOutputWorker.h"
 #include "utils.h"
 
 // forward declaration:
 class MainController;
 
 
+namespace OutputManagerConstants {
+    static const int channelsPerUniverse = 512;
+    // Art-Net has 15 bit port addresses, sACN universes go from 1 to 63999:
+    static const int maxUniverseCount = 32768;
+    static const int maxAddress = maxUniverseCount * channelsPerUniverse;
+}
+
+
 class OutputManager : public QObject
 {
 	Q_OBJECT
@@ -52,6 +60,7 @@ class OutputManager : public QObject
 
 public:
     OutputManager(MainController* controller);
+    ~OutputManager();
 
     /**
      * @brief getState returns the settings of this manager to persist them
@@ -77,16 +86,47 @@ signals:
 
 
 public slots:
+    /**
+     * @brief setChannel sets the value of a channel
+     * @param address absolute DMX address starting with 1 (i.e. 513 is the first channel of the second universe)
+     * @param value between 0 and 1
+     */
     void setChannel(int address, double value);
+    /**
+     * @brief setChannelInUniverse sets the value of a channel in a universe
+     * @param universe index of the universe starting with 0 (relative to start universe / subnet)
+     * @param channel channel in the universe starting with 1
+     * @param value between 0 and 1
+     */
+    void setChannelInUniverse(int universe, int channel, double value);
     void triggerOutput();
+
+    /**
+     * @brief updateFramePacing lets the network thread send with the frame clock
+     * if the engine is in realtime mode
+     */
+    void updateFramePacing();
     int getUnusedAddress(int footprint);
     void setNextAddressToUse(int address);
 
+    /**
+     * @brief getUniverseCount returns the number of universes in the universe table,
+     * including not yet used universes below the highest used one
+     * @return number of universes
+     */
+    int getUniverseCount() const { return m_universes.size(); }
+    /**
+     * @brief universeExists returns if any channel of this universe was set
+     * @param universe index of the universe starting with 0
+     * @return true if it exists
+     */
+    bool universeExists(int universe) const;
+
     bool getSAcnEnabled() const { return m_sAcnEnabled; }
-    void setSAcnEnabled(bool value) { m_sAcnEnabled = value; emit sAcnEnabledChanged(); }
+    void setSAcnEnabled(bool value) { m_sAcnEnabled = value; updateWorkerSettings(); emit sAcnEnabledChanged(); }
 
     bool getArtnetEnabled() const { return m_artnetEnabled; }
-    void setArtnetEnabled(bool value) { m_artnetEnabled = value; emit artnetEnabledChanged(); }
+    void setArtnetEnabled(bool value) { m_artnetEnabled = value; updateWorkerSettings(); emit artnetEnabledChanged(); }
 
     int getSAcnStartUniverse() const { return m_sAcnStartUniverse; }
     void setSAcnStartUniverse(int value);
@@ -101,12 +141,33 @@ public slots:
     void setArtnetSubnet(int value);
 
     bool getBroadcastArtnet() const { return m_broadcastArtnet; }
-    void setBroadcastArtnet(bool value) { m_broadcastArtnet = value; emit broadcastArtnetChanged(); }
+    void setBroadcastArtnet(bool value) { m_broadcastArtnet = value; updateWorkerSettings(); emit broadcastArtnetChanged(); }
+
+    /**
+     * @brief getSyscallsPerFrame returns the number of send syscalls needed for the last frame
+     * with changed universes (to verify the batched sending)
+     * @return number of syscalls
+     */
+    int getSyscallsPerFrame() const { return m_outputWorker->getSyscallsPerFrame(); }
 
     QVariantList getDiscoveredNodes();
     QVariantList getDiscoveredLuminosusInstances();
 
 protected:
+    /**
+     * @brief getUniverse returns the data of a universe and creates it if necessary
+     * @param universe index of the universe starting with 0
+     * @return the 512 channels of the universe
+     */
+    QVector<uint8_t>& getUniverse(int universe);
+
+    /**
+     * @brief updateWorkerSettings passes the current protocol settings to the network thread
+     */
+    void updateWorkerSettings();
+
+    MainController* const m_controller;  //!< a pointer to the MainController
+
     bool m_sAcnEnabled;
     bool m_artnetEnabled;
     int m_sAcnStartUniverse;
@@ -115,11 +176,14 @@ protected:
     int m_artnetSubnet;
     bool m_broadcastArtnet;
 
-    ArtNetSubnetSender m_artnet;
     //ArtNetDiscoveryManager m_artnetDiscoveryManager;
-    SAcnSender m_sAcnSender;
+    QThread m_networkThread;  //!< thread the universes are sent in
+    DmxOutputWorker* m_outputWorker;  //!< lives in m_networkThread, sends the universes
+
+    // sparse universe table, universes without any set channel have no data:
     QVector<QVector<uint8_t>> m_universes;
-    bool m_universeDirty[16];
+    QVector<bool> m_universeDirty;
+    QVector<int> m_dirtyUniverses;  //!< indexes of the universes that changed since the last output
     int m_usedAddressCount;
     int m_nextAddressToUse;
 };
@@ -0,0 +1,157 @@
+#include "UdpBatchSender.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef LUMINOSUS_USE_SENDMMSG
+#include <cerrno>
+#endif
+
+
+#ifdef LUMINOSUS_USE_SENDMMSG
+// the kernel accepts at most UIO_MAXIOV messages per sendmmsg call:
+static const int MAX_MESSAGES_PER_SYSCALL = 1024;
+#endif
+
+
+UdpBatchSender::UdpBatchSender()
+    : m_udpSocket()
+    , m_batchActive(false)
+    , m_datagrams()
+    , m_datagramCount(0)
+    , m_syscallCount(0)
+#ifdef LUMINOSUS_USE_SENDMMSG
+    , m_messages()
+    , m_iovecs()
+    , m_destinations()
+    , m_sendmmsgFailed(false)
+#endif
+{
+
+}
+
+void UdpBatchSender::beginBatch() {
+    m_batchActive = true;
+}
+
+void UdpBatchSender::writeDatagram(const char* data, int size, const QHostAddress& address, quint16 port) {
+    if (!m_batchActive) {
+        m_udpSocket.writeDatagram(data, size, address, port);
+        ++m_syscallCount;
+        return;
+    }
+    if (m_datagramCount >= m_datagrams.size()) {
+        m_datagrams.resize(m_datagramCount + 1);
+    }
+    Datagram& datagram = m_datagrams[m_datagramCount];
+    // the buffer keeps its capacity, so this doesn't allocate after the first frames:
+    datagram.data.resize(size);
+    std::memcpy(datagram.data.data(), data, size_t(size));
+    datagram.address = address;
+    datagram.port = port;
+    ++m_datagramCount;
+}
+
+void UdpBatchSender::flush() {
+    m_batchActive = false;
+    if (m_datagramCount == 0) return;
+#ifdef LUMINOSUS_USE_SENDMMSG
+    if (!m_sendmmsgFailed) {
+        sendWithSendmmsg();
+        m_datagramCount = 0;
+        return;
+    }
+#endif
+    sendSeparately(0, m_datagramCount);
+    m_datagramCount = 0;
+}
+
+void UdpBatchSender::sendSeparately(int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        const Datagram& datagram = m_datagrams[i];
+        m_udpSocket.writeDatagram(datagram.data, datagram.address, datagram.port);
+        ++m_syscallCount;
+    }
+}
+
+#ifdef LUMINOSUS_USE_SENDMMSG
+void UdpBatchSender::sendWithSendmmsg() {
+    // QUdpSocket creates its socket lazily, bind it to get a descriptor
+    // (this is the same as the implicit bind of the first writeDatagram):
+    if (m_udpSocket.state() != QAbstractSocket::BoundState) {
+        if (!m_udpSocket.bind(QHostAddress(QHostAddress::AnyIPv4), 0)) {
+            qWarning() << "UdpBatchSender: Could not bind socket:" << m_udpSocket.errorString();
+            m_sendmmsgFailed = true;
+            sendSeparately(0, m_datagramCount);
+            return;
+        }
+    }
+    const int socketDescriptor = int(m_udpSocket.socketDescriptor());
+
+    // prepare message headers (only IPv4 destinations can be sent with sendmmsg):
+    m_messages.resize(size_t(m_datagramCount));
+    m_iovecs.resize(size_t(m_datagramCount));
+    m_destinations.resize(size_t(m_datagramCount));
+    int messageCount = 0;
+    for (int i = 0; i < m_datagramCount; ++i) {
+        Datagram& datagram = m_datagrams[i];
+        if (datagram.address.protocol() != QAbstractSocket::IPv4Protocol) {
+            sendSeparately(i, i + 1);
+            continue;
+        }
+        sockaddr_in& destination = m_destinations[size_t(messageCount)];
+        std::memset(&destination, 0, sizeof(destination));
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(datagram.port);
+        destination.sin_addr.s_addr = htonl(datagram.address.toIPv4Address());
+
+        iovec& iov = m_iovecs[size_t(messageCount)];
+        iov.iov_base = datagram.data.data();
+        iov.iov_len = size_t(datagram.data.size());
+
+        mmsghdr& message = m_messages[size_t(messageCount)];
+        std::memset(&message, 0, sizeof(message));
+        message.msg_hdr.msg_name = &destination;
+        message.msg_hdr.msg_namelen = sizeof(destination);
+        message.msg_hdr.msg_iov = &iov;
+        message.msg_hdr.msg_iovlen = 1;
+        ++messageCount;
+    }
+
+    int offset = 0;
+    while (offset < messageCount) {
+        const int count = std::min(messageCount - offset, MAX_MESSAGES_PER_SYSCALL);
+        const int sent = ::sendmmsg(socketDescriptor, &m_messages[size_t(offset)], unsigned(count), 0);
+        ++m_syscallCount;
+        if (sent > 0) {
+            offset += sent;
+        } else if (sent < 0 && errno == EINTR) {
+            // interrupted by a signal before anything was sent, try again:
+            continue;
+        } else if (sent < 0 && errno == ENOSYS) {
+            // kernel without sendmmsg, use the fallback from now on:
+            qWarning() << "UdpBatchSender: sendmmsg not available, sending datagrams separately.";
+            m_sendmmsgFailed = true;
+            for (int i = offset; i < messageCount; ++i) {
+                const mmsghdr& message = m_messages[size_t(i)];
+                m_udpSocket.writeDatagram(static_cast<const char*>(message.msg_hdr.msg_iov->iov_base),
+                                          qint64(message.msg_hdr.msg_iov->iov_len),
+                                          QHostAddress(ntohl(m_destinations[size_t(i)].sin_addr.s_addr)),
+                                          ntohs(m_destinations[size_t(i)].sin_port));
+                ++m_syscallCount;
+            }
+            return;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // the send buffer is full, the following datagrams couldn't be sent either,
+            // the rest of this batch is dropped (unchanged universes are repeated by the keep-alive):
+            return;
+        } else {
+            // the first datagram could not be sent (i.e. network unreachable or too large),
+            // it is dropped and the rest is sent:
+            ++offset;
+        }
+    }
+}
+#endif
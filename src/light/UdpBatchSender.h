@@ -0,0 +1,84 @@
+#ifndef UDPBATCHSENDER_H
+#define UDPBATCHSENDER_H
+
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QByteArray>
+#include <QVector>
+
+#include <vector>
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#define LUMINOSUS_USE_SENDMMSG
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+
+/**
+ * @brief The UdpBatchSender class wraps a QUdpSocket and can collect the datagrams of a frame
+ * to send them together.
+ *
+ * Between beginBatch() and flush() all datagrams are copied to an internal buffer.
+ * On Linux they are then sent with as few sendmmsg() calls as possible,
+ * on other platforms (or for non-IPv4 destinations) each datagram is written separately.
+ * Outside of a batch datagrams are sent immediately.
+ */
+class UdpBatchSender
+{
+
+public:
+    UdpBatchSender();
+
+    /**
+     * @brief beginBatch starts collecting datagrams until flush() is called
+     */
+    void beginBatch();
+
+    /**
+     * @brief writeDatagram sends a datagram or adds it to the current batch
+     * @param data pointer to the datagram, is copied when collected
+     * @param size size of the datagram in bytes
+     * @param address destination address
+     * @param port destination port
+     */
+    void writeDatagram(const char* data, int size, const QHostAddress& address, quint16 port);
+
+    /**
+     * @brief flush sends all collected datagrams and ends the batch
+     */
+    void flush();
+
+    /**
+     * @brief getSyscallCount returns the number of send calls to the OS since the start
+     * @return number of syscalls
+     */
+    quint64 getSyscallCount() const { return m_syscallCount; }
+
+protected:
+    struct Datagram {
+        QByteArray data;
+        QHostAddress address;
+        quint16 port = 0;
+    };
+
+    void sendSeparately(int begin, int end);
+#ifdef LUMINOSUS_USE_SENDMMSG
+    void sendWithSendmmsg();
+#endif
+
+    QUdpSocket m_udpSocket;
+    bool m_batchActive;
+    QVector<Datagram> m_datagrams;  //!< reused between batches to keep the buffers allocated
+    int m_datagramCount;  //!< number of valid entries in m_datagrams
+    quint64 m_syscallCount;
+
+#ifdef LUMINOSUS_USE_SENDMMSG
+    std::vector<mmsghdr> m_messages;
+    std::vector<iovec> m_iovecs;
+    std::vector<sockaddr_in> m_destinations;
+    bool m_sendmmsgFailed;  //!< true if sendmmsg is not available, uses the fallback afterwards
+#endif
+};
+
+#endif // UDPBATCHSENDER_H
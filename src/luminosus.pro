@@ -3,7 +3,7 @@
 
 TEMPLATE = app
 
-QT += qml quick multimedia svg core-private networkauth
+QT += qml quick multimedia svg core-private networkauth concurrent
 
 CONFIG += c++14
 
@@ -134,6 +134,7 @@ SOURCES += main.cpp \
     core/Cue.cpp \
     core/MainController.cpp \
     core/Matrix.cpp \
+    core/ColorKernels.cpp \
     core/NodeData.cpp \
     core/Nodes.cpp \
     core/SmartAttribute.cpp \
@@ -147,6 +148,7 @@ SOURCES += main.cpp \
     core/manager/AnchorManager.cpp \
     core/manager/BlockManager.cpp \
     core/manager/Engine.cpp \
+    core/manager/FrameProfiler.cpp \
     core/manager/FileSystemManager.cpp \
     core/manager/GuiManager.cpp \
     core/manager/HandoffManager.cpp \
@@ -157,17 +159,23 @@ SOURCES += main.cpp \
     eos_specific/EosCue.cpp \
     eos_specific/EosCueList.cpp \
     eos_specific/EosCueListManager.cpp \
+    eos_specific/EosMessageRouter.cpp \
     eos_specific/EosOSCManager.cpp \
     eos_specific/EosOSCMessage.cpp \
     light/ArtNetDiscoveryManager.cpp \
     light/ArtNetSender.cpp \
     light/OutputManager.cpp \
+    light/DmxOutputWorker.cpp \
+    light/UdpBatchSender.cpp \
     midi/MidiManager.cpp \
     midi/MidiMappingManager.cpp \
     osc/GlobalOscCommands.cpp \
     osc/OSCMessage.cpp \
     osc/OSCNetworkManager.cpp \
     osc/OSCParser.cpp \
+    osc/OSCStreamDeframer.cpp \
+    osc/OSCRouter.cpp \
+    osc/OSCConnectionTelemetry.cpp \
     other/PowermateListener.cpp \
     other/X32Manager.cpp \
     qtquick_items/AudioBarSpectrumItem.cpp \
@@ -189,6 +197,9 @@ SOURCES += main.cpp \
     block_implementations/Logic/PresentationRemoteBlock.cpp \
     block_implementations/Eos/EosSpeedMasterBlock.cpp \
     sacn/sacnlistener.cpp \
+    sacn/sacnreceiver.cpp \
+    sacn/sacnmerge.cpp \
+    sacn/sacnsubscription.cpp \
     sacn/sacnsender.cpp \
     sacn/sacnsocket.cpp \
     sacn/sacnuniverselistmodel.cpp \
@@ -311,9 +322,12 @@ HEADERS += \
     core/Cue.h \
     core/MainController.h \
     core/Matrix.h \
+    core/ColorKernels.h \
+    core/ColorKernelsImpl.h \
     core/NodeData.h \
     core/Nodes.h \
     core/QCircularBuffer.h \
+    core/TripleBuffer.h \
     core/SmartAttribute.h \
     core/block_data/BlockBase.h \
     core/block_data/BlockInterface.h \
@@ -326,6 +340,7 @@ HEADERS += \
     core/manager/AnchorManager.h \
     core/manager/BlockManager.h \
     core/manager/Engine.h \
+    core/manager/FrameProfiler.h \
     core/manager/FileSystemManager.h \
     core/manager/GuiManager.h \
     core/manager/HandoffManager.h \
@@ -336,6 +351,7 @@ HEADERS += \
     eos_specific/EosCue.h \
     eos_specific/EosCueList.h \
     eos_specific/EosCueListManager.h \
+    eos_specific/EosMessageRouter.h \
     eos_specific/EosOSCManager.h \
     eos_specific/EosOSCMessage.h \
     ffft/Array.h \
@@ -361,12 +377,17 @@ HEADERS += \
     light/ArtNetDiscoveryManager.h \
     light/ArtNetSender.h \
     light/OutputManager.h \
+    light/DmxOutputWorker.h \
+    light/UdpBatchSender.h \
     midi/MidiManager.h \
     midi/MidiMappingManager.h \
     osc/GlobalOscCommands.h \
     osc/OSCMessage.h \
     osc/OSCNetworkManager.h \
     osc/OSCParser.h \
+    osc/OSCStreamDeframer.h \
+    osc/OSCRouter.h \
+    osc/OSCConnectionTelemetry.h \
     other/PowermateListener.h \
     other/X32Manager.h \
     qtquick_items/AudioBarSpectrumItem.h \
@@ -390,6 +411,9 @@ HEADERS += \
     block_implementations/Logic/PresentationRemoteBlock.h \
     block_implementations/Eos/EosSpeedMasterBlock.h \
     sacn/sacnlistener.h \
+    sacn/sacnreceiver.h \
+    sacn/sacnmerge.h \
+    sacn/sacnsubscription.h \
     sacn/sacnsender.h \
     sacn/sacnsocket.h \
     sacn/sacnuniverselistmodel.h \
@@ -498,3 +522,13 @@ macx:LIBS += -framework CoreMIDI -framework CoreAudio -framework CoreFoundation
 
 # Android specific files:
 ANDROID_PACKAGE_SOURCE_DIR = $$PWD/android
+
+# Build the AVX2 color kernels on x86 with a separate compiler flag,
+# they are only used if the CPU supports AVX2 (see core/ColorKernels.cpp):
+!mobile_platform:!isEmpty(QMAKE_CFLAGS_AVX2) {
+    contains(QT_ARCH, x86_64)|contains(QT_ARCH, i386) {
+        CONFIG += simd
+        AVX2_SOURCES += core/ColorKernelsAvx2.cpp
+        DEFINES += LUMINOSUS_AVX2_KERNELS
+    }
+}
@@ -0,0 +1,217 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "OSCConnectionTelemetry.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <QUrl>
+#include <QVariantMap>
+#include <QDebug>
+
+#include <chrono>
+#include <cmath>
+
+
+OSCConnectionTelemetry::OSCConnectionTelemetry(QObject* parent)
+	: QObject(parent)
+	, m_intervalStart(nowMicroseconds())
+	, m_messagesIn(0)
+	, m_bytesIn(0)
+	, m_messagesOut(0)
+	, m_bytesOut(0)
+	, m_maxQueueDepth(0)
+	, m_maxPendingBytes(0)
+	, m_connections(0)
+	, m_connectionErrors(0)
+	, m_parseErrors(0)
+	, m_rttIntervalHistograms(OSCConnectionTelemetryConstants::rttWindowLength,
+							  QVector<int>(OSCConnectionTelemetryConstants::rttBucketCount, 0))
+	, m_rttIntervalIndex(0)
+	, m_rttHistogram(OSCConnectionTelemetryConstants::rttBucketCount, 0)
+	, m_rttCount(0)
+	, m_history(OSCConnectionTelemetryConstants::historyLength)
+{
+	m_sampleTimer.setInterval(OSCConnectionTelemetryConstants::sampleInterval);
+	connect(&m_sampleTimer, SIGNAL(timeout()), this, SLOT(takeSample()));
+	m_sampleTimer.start();
+}
+
+qint64 OSCConnectionTelemetry::nowMicroseconds()
+{
+	using namespace std::chrono;
+	return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void OSCConnectionTelemetry::addConnectionEstablished()
+{
+	++m_connections;
+}
+
+void OSCConnectionTelemetry::updateQueueDepth(int messages, qint64 pendingBytes)
+{
+	m_maxQueueDepth = qMax(m_maxQueueDepth, messages);
+	m_maxPendingBytes = qMax(m_maxPendingBytes, pendingBytes);
+}
+
+void OSCConnectionTelemetry::addRoundTripTime(qint64 microseconds)
+{
+	// bucket b contains the times in [2^(b/n), 2^((b+1)/n)) µs with n buckets per octave:
+	int bucket = 0;
+	if (microseconds > 1) {
+		bucket = int(std::log2(double(microseconds)) * OSCConnectionTelemetryConstants::rttBucketsPerOctave);
+	}
+	bucket = qBound(0, bucket, OSCConnectionTelemetryConstants::rttBucketCount - 1);
+	++m_rttIntervalHistograms[m_rttIntervalIndex][bucket];
+	++m_rttHistogram[bucket];
+	++m_rttCount;
+}
+
+double OSCConnectionTelemetry::getRttPercentile(double percentile) const
+{
+	if (m_rttCount == 0) return -1;
+	const int target = qMax(1, int(std::ceil(percentile * m_rttCount)));
+	int count = 0;
+	for (int bucket = 0; bucket < m_rttHistogram.size(); ++bucket) {
+		count += m_rttHistogram[bucket];
+		if (count >= target) {
+			// geometric center of the bucket in ms:
+			const double exponent = (bucket + 0.5) / OSCConnectionTelemetryConstants::rttBucketsPerOctave;
+			return std::pow(2.0, exponent) / 1000.0;
+		}
+	}
+	return -1;
+}
+
+void OSCConnectionTelemetry::clear()
+{
+	m_intervalStart = nowMicroseconds();
+	m_messagesIn = 0;
+	m_bytesIn = 0;
+	m_messagesOut = 0;
+	m_bytesOut = 0;
+	m_maxQueueDepth = 0;
+	m_maxPendingBytes = 0;
+	// a connection that is currently open is not counted again:
+	m_connections = qMin(m_connections, 1);
+	m_connectionErrors = 0;
+	m_parseErrors = 0;
+	for (QVector<int>& histogram: m_rttIntervalHistograms) {
+		histogram.fill(0);
+	}
+	m_rttHistogram.fill(0);
+	m_rttCount = 0;
+	m_lastSample = TelemetrySample();
+	m_history.clear();
+	emit updated();
+}
+
+QVariantList OSCConnectionTelemetry::getHistory() const
+{
+	QVariantList samples;
+	for (int i = 0; i < m_history.size(); ++i) {
+		const TelemetrySample& sample = m_history.at(i);
+		QVariantMap info;
+		info["time"] = double(sample.time);
+		info["messagesIn"] = sample.messagesIn;
+		info["bytesIn"] = sample.bytesIn;
+		info["messagesOut"] = sample.messagesOut;
+		info["bytesOut"] = sample.bytesOut;
+		info["queueDepth"] = sample.queueDepth;
+		info["pendingBytes"] = double(sample.pendingBytes);
+		info["rttP50"] = sample.rttP50;
+		info["rttP95"] = sample.rttP95;
+		info["rttP99"] = sample.rttP99;
+		info["reconnects"] = sample.reconnects;
+		info["connectionErrors"] = sample.connectionErrors;
+		info["parseErrors"] = sample.parseErrors;
+		samples.append(info);
+	}
+	return samples;
+}
+
+bool OSCConnectionTelemetry::dumpToFile(QString filename) const
+{
+	if (filename.startsWith("file:")) {
+		filename = QUrl(filename).toLocalFile();
+	}
+	QFile file(filename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+		qWarning() << "Could not open file to write connection telemetry:" << filename;
+		return false;
+	}
+	QTextStream out(&file);
+	out << "time,messages_in_per_s,bytes_in_per_s,messages_out_per_s,bytes_out_per_s,"
+		   "queue_depth,pending_bytes,rtt_p50_ms_last_60s,rtt_p95_ms_last_60s,rtt_p99_ms_last_60s,"
+		   "reconnects,connection_errors,parse_errors\n";
+	for (int i = 0; i < m_history.size(); ++i) {
+		const TelemetrySample& sample = m_history.at(i);
+		out << QDateTime::fromMSecsSinceEpoch(sample.time).toString(Qt::ISODateWithMs)
+			<< "," << sample.messagesIn << "," << sample.bytesIn
+			<< "," << sample.messagesOut << "," << sample.bytesOut
+			<< "," << sample.queueDepth << "," << sample.pendingBytes
+			<< "," << sample.rttP50 << "," << sample.rttP95 << "," << sample.rttP99
+			<< "," << sample.reconnects << "," << sample.connectionErrors << "," << sample.parseErrors << "\n";
+	}
+	return true;
+}
+
+void OSCConnectionTelemetry::takeSample()
+{
+	const qint64 now = nowMicroseconds();
+	const double seconds = qMax(qint64(1), now - m_intervalStart) / 1000000.0;
+	m_intervalStart = now;
+
+	TelemetrySample sample;
+	sample.time = QDateTime::currentMSecsSinceEpoch();
+	sample.messagesIn = m_messagesIn / seconds;
+	sample.bytesIn = m_bytesIn / seconds;
+	sample.messagesOut = m_messagesOut / seconds;
+	sample.bytesOut = m_bytesOut / seconds;
+	sample.queueDepth = m_maxQueueDepth;
+	sample.pendingBytes = m_maxPendingBytes;
+	sample.rttP50 = getRttPercentile(0.50);
+	sample.rttP95 = getRttPercentile(0.95);
+	sample.rttP99 = getRttPercentile(0.99);
+	sample.reconnects = qMax(0, m_connections - 1);
+	sample.connectionErrors = m_connectionErrors;
+	sample.parseErrors = m_parseErrors;
+
+	m_messagesIn = 0;
+	m_bytesIn = 0;
+	m_messagesOut = 0;
+	m_bytesOut = 0;
+	m_maxQueueDepth = 0;
+	m_maxPendingBytes = 0;
+
+	// the oldest interval leaves the window of the round trip times:
+	m_rttIntervalIndex = (m_rttIntervalIndex + 1) % m_rttIntervalHistograms.size();
+	QVector<int>& oldest = m_rttIntervalHistograms[m_rttIntervalIndex];
+	for (int bucket = 0; bucket < oldest.size(); ++bucket) {
+		m_rttHistogram[bucket] -= oldest[bucket];
+		m_rttCount -= oldest[bucket];
+	}
+	oldest.fill(0);
+
+	m_lastSample = sample;
+	m_history.append(sample);
+	emit updated();
+}
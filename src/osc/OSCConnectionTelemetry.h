@@ -0,0 +1,229 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef OSCCONNECTIONTELEMETRY_H
+#define OSCCONNECTIONTELEMETRY_H
+
+#include "core/QCircularBuffer.h"
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <QVariantList>
+
+
+/**
+ * @brief The OSCConnectionTelemetryConstants namespace contains all constants used in OSCConnectionTelemetry.
+ */
+namespace OSCConnectionTelemetryConstants {
+	/**
+	 * @brief sampleInterval is the time between two samples in ms
+	 */
+	static const int sampleInterval = 1000;  // in ms
+	/**
+	 * @brief historyLength is the number of samples kept in the ring buffer (10 minutes)
+	 */
+	static const int historyLength = 600;
+	/**
+	 * @brief rttBucketsPerOctave is the number of histogram buckets per doubling of the round trip time
+	 */
+	static const int rttBucketsPerOctave = 4;
+	/**
+	 * @brief rttBucketCount is the number of histogram buckets (1 µs to about 67 s)
+	 */
+	static const int rttBucketCount = 26 * rttBucketsPerOctave;
+	/**
+	 * @brief rttWindowLength is the number of sample intervals the round trip percentiles are computed of
+	 */
+	static const int rttWindowLength = 60;
+}
+
+
+/**
+ * @brief The TelemetrySample struct contains the state of a connection during one sample interval.
+ */
+struct TelemetrySample {
+	TelemetrySample()
+		: time(0), messagesIn(0), bytesIn(0), messagesOut(0), bytesOut(0)
+		, queueDepth(0), pendingBytes(0), rttP50(-1), rttP95(-1), rttP99(-1)
+		, reconnects(0), connectionErrors(0), parseErrors(0) {}
+
+	qint64 time;  //!< end of the interval in ms since epoch
+	double messagesIn;  //!< received messages per second
+	double bytesIn;  //!< received bytes per second
+	double messagesOut;  //!< sent messages per second
+	double bytesOut;  //!< sent bytes per second
+	int queueDepth;  //!< maximum number of messages queued for one frame
+	qint64 pendingBytes;  //!< maximum number of bytes waiting in the TCP socket
+	double rttP50;  //!< median round trip time of the last rttWindowLength intervals in ms or -1
+	double rttP95;  //!< 95th percentile of the round trip time of the last rttWindowLength intervals in ms or -1
+	double rttP99;  //!< 99th percentile of the round trip time of the last rttWindowLength intervals in ms or -1
+	int reconnects;  //!< total count of reconnects
+	int connectionErrors;  //!< total count of connection errors
+	int parseErrors;  //!< total count of invalid packets and messages
+};
+
+
+/**
+ * @brief The OSCConnectionTelemetry class collects statistics of a single OSC connection.
+ *
+ * The OSCNetworkManager counts the traffic in both directions, the depth of the outgoing queue,
+ * reconnects and parse errors. Round trip times are added by the protocol specific managers
+ * (i.e. the Eos ping) with microsecond resolution and are stored in histograms with logarithmic
+ * buckets per interval, so that percentiles of the last minute can be computed without keeping
+ * each measurement.
+ *
+ * Once per second the rates are calculated and a sample is added to a ring buffer that
+ * can be read from QML or dumped to a CSV file.
+ */
+class OSCConnectionTelemetry : public QObject
+{
+	Q_OBJECT
+
+	Q_PROPERTY(double messagesInPerSecond READ getMessagesInPerSecond NOTIFY updated)
+	Q_PROPERTY(double bytesInPerSecond READ getBytesInPerSecond NOTIFY updated)
+	Q_PROPERTY(double messagesOutPerSecond READ getMessagesOutPerSecond NOTIFY updated)
+	Q_PROPERTY(double bytesOutPerSecond READ getBytesOutPerSecond NOTIFY updated)
+	Q_PROPERTY(int queueDepth READ getQueueDepth NOTIFY updated)
+	Q_PROPERTY(double pendingBytes READ getPendingBytes NOTIFY updated)
+	Q_PROPERTY(double rttP50 READ getRttP50 NOTIFY updated)
+	Q_PROPERTY(double rttP95 READ getRttP95 NOTIFY updated)
+	Q_PROPERTY(double rttP99 READ getRttP99 NOTIFY updated)
+	Q_PROPERTY(int rttCount READ getRttCount NOTIFY updated)
+	Q_PROPERTY(int reconnects READ getReconnects NOTIFY updated)
+	Q_PROPERTY(int connectionErrors READ getConnectionErrors NOTIFY updated)
+	Q_PROPERTY(int parseErrors READ getParseErrors NOTIFY updated)
+
+public:
+	explicit OSCConnectionTelemetry(QObject* parent = nullptr);
+
+	/**
+	 * @brief nowMicroseconds returns a monotonic timestamp to measure round trip times
+	 * @return time in µs
+	 */
+	static qint64 nowMicroseconds();
+
+	// ------------------- to be called by the OSCNetworkManager:
+
+	void addIncomingBytes(int bytes) { m_bytesIn += bytes; }
+	void addIncomingMessage() { ++m_messagesIn; }
+	void addOutgoingBytes(int bytes) { m_bytesOut += bytes; }
+	void addOutgoingMessages(int count) { m_messagesOut += count; }
+	void addParseError() { ++m_parseErrors; }
+	void addConnectionError() { ++m_connectionErrors; }
+
+	/**
+	 * @brief addConnectionEstablished counts a new connection, every connection after
+	 * the first one is a reconnect
+	 */
+	void addConnectionEstablished();
+
+	/**
+	 * @brief updateQueueDepth records the size of the outgoing queue, the maximum per interval is kept
+	 * @param messages number of messages queued in this frame
+	 * @param pendingBytes number of bytes not yet written by the TCP socket
+	 */
+	void updateQueueDepth(int messages, qint64 pendingBytes);
+
+	/**
+	 * @brief addRoundTripTime adds a measured round trip time to the histogram
+	 * @param microseconds the round trip time in µs
+	 */
+	void addRoundTripTime(qint64 microseconds);
+
+signals:
+	/**
+	 * @brief updated is emitted after a new sample was added to the history
+	 */
+	void updated();
+
+public slots:
+	double getMessagesInPerSecond() const { return m_lastSample.messagesIn; }
+	double getBytesInPerSecond() const { return m_lastSample.bytesIn; }
+	double getMessagesOutPerSecond() const { return m_lastSample.messagesOut; }
+	double getBytesOutPerSecond() const { return m_lastSample.bytesOut; }
+	int getQueueDepth() const { return m_lastSample.queueDepth; }
+	double getPendingBytes() const { return double(m_lastSample.pendingBytes); }
+	double getRttP50() const { return m_lastSample.rttP50; }
+	double getRttP95() const { return m_lastSample.rttP95; }
+	double getRttP99() const { return m_lastSample.rttP99; }
+	int getRttCount() const { return m_rttCount; }
+	int getReconnects() const { return m_lastSample.reconnects; }
+	int getConnectionErrors() const { return m_lastSample.connectionErrors; }
+	int getParseErrors() const { return m_lastSample.parseErrors; }
+
+	/**
+	 * @brief getRttPercentile returns a percentile of the round trip times of the last
+	 * rttWindowLength intervals
+	 * @param percentile in the range [0...1], i.e. 0.95
+	 * @return round trip time in ms or -1 if nothing was measured
+	 */
+	double getRttPercentile(double percentile) const;
+
+	/**
+	 * @brief clear resets all counters, the histogram and the history
+	 */
+	void clear();
+
+	/**
+	 * @brief getHistory returns the recorded samples (oldest first) to be displayed in QML
+	 * @return a list of maps with the keys of the CSV columns
+	 */
+	QVariantList getHistory() const;
+
+	/**
+	 * @brief dumpToFile writes the recorded samples to a CSV file
+	 * @param filename the absolute path or a file URL (i.e. from a FileDialog)
+	 * @return true if successful
+	 */
+	bool dumpToFile(QString filename) const;
+
+private slots:
+	/**
+	 * @brief takeSample calculates the rates of the last interval and adds a sample to the history
+	 */
+	void takeSample();
+
+protected:
+	QTimer m_sampleTimer;  //!< timer that calls takeSample()
+	qint64 m_intervalStart;  //!< start of the current interval in µs
+
+	// counters of the current interval:
+	qint64 m_messagesIn;
+	qint64 m_bytesIn;
+	qint64 m_messagesOut;
+	qint64 m_bytesOut;
+	int m_maxQueueDepth;
+	qint64 m_maxPendingBytes;
+
+	// totals since the last clear():
+	int m_connections;  //!< number of established connections
+	int m_connectionErrors;
+	int m_parseErrors;
+	QVector<QVector<int>> m_rttIntervalHistograms;  //!< ring of histograms of the last intervals
+	int m_rttIntervalIndex;  //!< index of the histogram of the current interval
+	QVector<int> m_rttHistogram;  //!< sum of the interval histograms (count per logarithmic bucket)
+	int m_rttCount;  //!< number of round trip times in m_rttHistogram
+
+	TelemetrySample m_lastSample;  //!< the most recent sample
+	Qt3DCore::QCircularBuffer<TelemetrySample> m_history;  //!< ring buffer of the last samples
+};
+
+#endif // OSCCONNECTIONTELEMETRY_H
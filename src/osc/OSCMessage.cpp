@@ -23,10 +23,12 @@
 #include "OSCParser.h"
 
 #include <QDebug>
+#include <cstring>
 
 OSCMessage::OSCMessage()
 	: m_pathString()
 	, m_path()
+	, m_pathIsSplit(true)
 	, m_arguments(0)
 	, m_isValid(false)
 {
@@ -36,81 +38,118 @@ OSCMessage::OSCMessage()
 OSCMessage::OSCMessage(const QByteArray &data, bool convertNumberStrings)
 	: m_pathString()
 	, m_path()
+	, m_pathIsSplit(true)
 	, m_arguments(0)
 	, m_isValid(false)
 {
-	setData(data, convertNumberStrings);
+	setData(data.constData(), data.size(), convertNumberStrings);
+}
+
+OSCMessage::OSCMessage(const char* data, int size, bool convertNumberStrings)
+	: m_pathString()
+	, m_path()
+	, m_pathIsSplit(true)
+	, m_arguments(0)
+	, m_isValid(false)
+{
+	setData(data, size, convertNumberStrings);
 }
 
 void OSCMessage::setData(const QByteArray &data, bool convertNumberStrings)
 {
-	// set path:
-	m_pathString = getPathFromMessage(data);
-	m_path = m_pathString.split("/");
-	// since the string always starts with "/" the first element of path is empty:
-	m_path.removeFirst();
+	setData(data.constData(), data.size(), convertNumberStrings);
+}
 
-	// message is valid when the path is not empty:
-	if (!m_path.isEmpty()) {
-		m_isValid = true;
+// maximum number of arguments that are parsed without allocating memory:
+static const size_t MAX_STACK_ARGUMENTS = 16;
+
+void OSCMessage::setData(const char* data, int size, bool convertNumberStrings)
+{
+	m_arguments.clear();
+
+	// set path, it is split into parts only when needed:
+	m_pathString = getPathFromMessage(data, size);
+	m_path.clear();
+	m_pathIsSplit = false;
+
+	// message is valid when the path is not empty
+	// (the part before the first slash is not part of the path):
+	m_isValid = m_pathString.contains('/');
+
+	// get arguments as views into the data, without allocating them if possible:
+	OSCArgument stackArgs[MAX_STACK_ARGUMENTS];
+	OSCArgument* heapArgs = nullptr;
+	OSCArgument* args = stackArgs;
+	size_t argumentCount = MAX_STACK_ARGUMENTS;
+	size_t totalCount = OSCArgument::GetArgs(const_cast<char*>(data), size_t(qMax(size, 0)), stackArgs, argumentCount);
+	if (argumentCount == MAX_STACK_ARGUMENTS && totalCount > MAX_STACK_ARGUMENTS) {
+		// more arguments than fit on the stack:
+		argumentCount = totalCount;
+		heapArgs = new OSCArgument[totalCount];
+		OSCArgument::GetArgs(const_cast<char*>(data), size_t(size), heapArgs, argumentCount);
+		args = heapArgs;
 	}
 
-	// set arguments:
-	size_t argumentCount = 0xffffffff;  // this is also maximum arguments
-	OSCArgument* args = OSCArgument::GetArgs(const_cast<char*>(data.data()), data.size(), argumentCount);
-	if( args ) {
-		// iterate over arguments and try to convert them to corresponding QVariants:
-		for(size_t i=0; i<argumentCount; i++) {
-			OSCArgument &arg = args[i];
-			int intValue = 0;
-			double doubleValue = 0;
-			std::string stringValue = "";
-
-			switch (arg.GetType()) {
-			case OSCArgument::OSC_TYPE_FALSE:
-				m_arguments.append(QVariant(false));
-				break;
-			case OSCArgument::OSC_TYPE_TRUE:
-				m_arguments.append(QVariant(true));
-				break;
-			case OSCArgument::OSC_TYPE_INT32:  // intended fallthrough
-			case OSCArgument::OSC_TYPE_INT64:
+	// iterate over arguments and try to convert them to corresponding QVariants:
+	m_arguments.reserve(int(argumentCount));
+	for(size_t i=0; i<argumentCount; i++) {
+		const OSCArgument &arg = args[i];
+		int intValue = 0;
+		double doubleValue = 0;
+
+		switch (arg.GetType()) {
+		case OSCArgument::OSC_TYPE_FALSE:
+			m_arguments.append(QVariant(false));
+			break;
+		case OSCArgument::OSC_TYPE_TRUE:
+			m_arguments.append(QVariant(true));
+			break;
+		case OSCArgument::OSC_TYPE_INT32:  // intended fallthrough
+		case OSCArgument::OSC_TYPE_INT64:
+			arg.GetInt(intValue);
+			m_arguments.append(QVariant(intValue));
+			break;
+		case OSCArgument::OSC_TYPE_FLOAT32:  // intended fallthrough
+		case OSCArgument::OSC_TYPE_FLOAT64:
+			arg.GetDouble(doubleValue);
+			m_arguments.append(QVariant(doubleValue));
+			break;
+		case OSCArgument::OSC_TYPE_STRING:
+			if (convertNumberStrings && OSCArgument::IsIntString(arg.GetRaw())) {
 				arg.GetInt(intValue);
 				m_arguments.append(QVariant(intValue));
-				break;
-			case OSCArgument::OSC_TYPE_FLOAT32:  // intended fallthrough
-			case OSCArgument::OSC_TYPE_FLOAT64:
+			} else if (convertNumberStrings && OSCArgument::IsFloatString(arg.GetRaw())) {
 				arg.GetDouble(doubleValue);
 				m_arguments.append(QVariant(doubleValue));
-				break;
-			case OSCArgument::OSC_TYPE_STRING:
-				if (convertNumberStrings && OSCArgument::IsIntString(arg.GetRaw())) {
-					arg.GetInt(intValue);
-					m_arguments.append(QVariant(intValue));
-				} else if (convertNumberStrings && OSCArgument::IsFloatString(arg.GetRaw())) {
-					arg.GetDouble(doubleValue);
-					m_arguments.append(QVariant(doubleValue));
-				} else {
-					arg.GetString(stringValue);
-					m_arguments.append(QVariant(QString::fromStdString(stringValue)));
-				}
-				break;
-			default:
-				qDebug() << "OSC Argument Type not supported. Type: " << OSCArgument::GetCharFromArgumentType(arg.GetType());
-				m_arguments.append(QVariant());
-			}  // end switch
-		}  // end for (arguments)
-
-		delete[] args;
-	}  // end if (args)
+			} else {
+				// the string is not necessarily null-terminated at the end of the data:
+				const int length = int(qstrnlen(arg.GetRaw(), uint(arg.GetSize())));
+				m_arguments.append(QVariant(QString::fromUtf8(arg.GetRaw(), length)));
+			}
+			break;
+		default:
+			qDebug() << "OSC Argument Type not supported. Type: " << OSCArgument::GetCharFromArgumentType(arg.GetType());
+			m_arguments.append(QVariant());
+		}  // end switch
+	}  // end for (arguments)
+
+	delete[] heapArgs;
+}
+
+void OSCMessage::splitPath() const
+{
+	m_path = m_pathString.split("/");
+	// since the string always starts with "/" the first element of path is empty:
+	m_path.removeFirst();
+	m_pathIsSplit = true;
 }
 
 QString OSCMessage::pathPart(int index) const
 {
     if (index < 0) {
-        index = m_path.size() + index;
+        index = path().size() + index;
     }
-	if (m_path.size() <= index) {
+	if (path().size() <= index) {
 		return "";
 	}
 	return m_path[index];
@@ -169,7 +208,7 @@ QString OSCMessage::getArgumentsAsDebugString()
 void OSCMessage::printToQDebug() const
 {
     qInfo() << "---------------------------------";
-    qInfo() << "Path: " << m_path;
+    qInfo() << "Path: " << path();
 	for (int i=0; i<m_arguments.size(); ++i) {
 		const QVariant& arg = m_arguments[i];
 		if (arg.type() == QVariant::Int) {
@@ -186,20 +225,15 @@ void OSCMessage::printToQDebug() const
 	}
 }
 
-QString OSCMessage::getPathFromMessage(const QByteArray &data)
+QString OSCMessage::getPathFromMessage(const char* data, int size)
 {
 	// The path of an OSC message is a string from the beginning to the first null character.
-
-	// iterate over each character:
-	for (int i=0; i<data.size(); ++i) {
-		// check if character is null:
-		if (data[i] == 0) {
-			// the character is null -> end of path
-			QString path = QString::fromLatin1(data.data(), i);
-			return path;
-		}
+	if (size <= 0) return QString();
+	const char* end = static_cast<const char*>(memchr(data, 0, size_t(size)));
+	if (!end) {
+		// there is no null-termination in the data
+		// return an empty string:
+		return QString();
 	}
-	// there is no null-termination in the data
-	// return an empty string:
-	return QString();
+	return QString::fromLatin1(data, int(end - data));
 }
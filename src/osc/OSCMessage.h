@@ -52,6 +52,15 @@ public:
 	 */
 	OSCMessage(const QByteArray& data, bool convertNumberStrings = false);
 
+	/**
+	 * @brief OSCMessage creates a message from raw OSC data in a buffer
+	 * (the data is not used after the constructor returned)
+	 * @param data pointer to raw OSC packet data (without frame)
+	 * @param size size of the data in bytes
+	 * @param convertNumberStrings true to convert strings containing only digits to numbers
+	 */
+	OSCMessage(const char* data, int size, bool convertNumberStrings = false);
+
 	/**
 	 * @brief setData sets the data from the raw OSC data
 	 * @param data raw OSC packet data (without frame)
@@ -59,6 +68,15 @@ public:
 	 */
 	void setData(const QByteArray& data, bool convertNumberStrings = false);
 
+	/**
+	 * @brief setData sets the data from raw OSC data in a buffer.
+	 * The arguments are parsed in place, only string arguments and the path string are copied.
+	 * @param data pointer to raw OSC packet data (without frame)
+	 * @param size size of the data in bytes
+	 * @param convertNumberStrings true to convert strings containing only digits to numbers
+	 */
+	void setData(const char* data, int size, bool convertNumberStrings = false);
+
 	/**
 	 * @brief isValid returns if the message is valid and not emtpy
 	 * @return true if valid and not empty
@@ -67,9 +85,10 @@ public:
 
 	/**
 	 * @brief path returns the path as a list of strings
+	 * (it is only split when it is used the first time)
 	 * @return the path separated at the slashes
 	 */
-	const QStringList& path() const { return m_path; }
+	const QStringList& path() const { if (!m_pathIsSplit) splitPath(); return m_path; }
 
 	/**
 	 * @brief pathPart returns a specific part of the path
@@ -134,9 +153,15 @@ private:
 	/**
 	 * @brief getPathFromMessage extracts the path string from the raw OSC packet data
 	 * @param data the raw OSC packet data (without frame)
+	 * @param size size of the data in bytes
 	 * @return path string
 	 */
-	static QString getPathFromMessage(const QByteArray& data);
+	static QString getPathFromMessage(const char* data, int size);
+
+	/**
+	 * @brief splitPath splits the path string into m_path
+	 */
+	void splitPath() const;
 
 protected:
 	/**
@@ -144,9 +169,14 @@ protected:
 	 */
 	QString				m_pathString;
 	/**
-	 * @brief m_path stores the path as a list of strings (separated at slashes)
+	 * @brief m_path stores the path as a list of strings (separated at slashes),
+	 * only valid if m_pathIsSplit is true
+	 */
+	mutable QStringList	m_path;
+	/**
+	 * @brief m_pathIsSplit is true if m_path has been created from m_pathString
 	 */
-	QStringList			m_path;
+	mutable bool		m_pathIsSplit;
 	/**
 	 * @brief m_arguments is the list of arguments as QVariants
 	 */
@@ -2,14 +2,25 @@
 
 #include <QTime>
 #include <QUuid>
+#include <cstring>
 
-// http://www.rfc-editor.org/rfc/rfc1055.txt
-#define SLIP_END		0xc0    /* indicates end of packet */
-#define SLIP_ESC		0xdb    /* indicates byte stuffing */
-#define SLIP_ESC_END	0xdc    /* ESC ESC_END means END data byte */
-#define SLIP_ESC_ESC	0xdd    /* ESC ESC_ESC means ESC data byte */
+// initial size of the UDP receive buffer, it grows if a larger datagram arrives
+static const int UDP_RECEIVE_BUFFER_SIZE = 2048;
+
+// size of "#bundle\0" and the timetag at the beginning of a bundle
+static const int BUNDLE_HEADER_SIZE = 16;
+
+// "#bundle\0" and the timetag 1, which means "immediately":
+static const char BUNDLE_HEADER[BUNDLE_HEADER_SIZE] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', 0, 0, 0, 0, 0, 0, 0, 0, 1};
 
-#define SLIP_CHAR(x)	static_cast<char>(static_cast<unsigned char>(x))
+// initial capacity of the buffers for outgoing data of one frame
+static const int OUTGOING_BUFFER_SIZE = 4096;
+
+// http://www.rfc-editor.org/rfc/rfc1055.txt
+static const char SLIP_END = char(0xc0);
+static const char SLIP_ESC = char(0xdb);
+static const char SLIP_ESC_END = char(0xdc);
+static const char SLIP_ESC_ESC = char(0xdd);
 
 
 OSCNetworkManager::OSCNetworkManager(QObject* parent, QStringList availableTypes)
@@ -24,8 +35,16 @@ OSCNetworkManager::OSCNetworkManager(QObject* parent, QStringList availableTypes
 	, m_log()
 	, m_logIncomingMsg(true)
     , m_logOutgoingMsg(true)
-	, m_incompleteStreamData()
+	, m_tcpDeframer(OSCStream::FRAME_MODE_1_0)
+	, m_telemetry(this)
+	, m_udpReceiveBuffer(UDP_RECEIVE_BUFFER_SIZE, Qt::Uninitialized)
+	, m_outgoingBundleCount(0)
 {
+	// reserve capacity, so that resize(0) keeps the memory for the next frame:
+	m_outgoingData.reserve(OUTGOING_BUFFER_SIZE);
+	m_outgoingBundle.reserve(OUTGOING_BUFFER_SIZE);
+	m_outgoingTcpFrames.reserve(OUTGOING_BUFFER_SIZE);
+
     // prepare log changed signal:
     m_logChangedSignalDelay.setSingleShot(true);
     m_logChangedSignalDelay.setInterval(100);
@@ -142,14 +161,17 @@ void OSCNetworkManager::reconnect() {
     if (preset["protocol"].toString() == OscProtocol::UDP) {
         m_useTcp = false;
         m_udpSocket.bind(quint16(preset["udpRxPort"].toInt()));
+        m_telemetry.addConnectionEstablished();
         emit isConnectedChanged();
     } else if (preset["protocol"].toString() == OscProtocol::TCP_1_0) {
         m_useTcp = true;
         m_tcpFrameMode = OSCStream::FRAME_MODE_1_0;
+        m_tcpDeframer.setFrameMode(m_tcpFrameMode);
         m_tryConnectAgainTimer.start(20);
     } else if (preset["protocol"].toString() == OscProtocol::TCP_1_1) {
         m_useTcp = true;
         m_tcpFrameMode = OSCStream::FRAME_MODE_1_1;
+        m_tcpDeframer.setFrameMode(m_tcpFrameMode);
         m_tryConnectAgainTimer.start(20);
     } else {
         qWarning() << "OSCNetworkManager: preset has invalid protocol";
@@ -166,9 +188,10 @@ void OSCNetworkManager::sendMessage(QString messageString, bool forced)
 {
     if (!m_isEnabled && !forced) return;
 
-    size_t outSize = 0;
-	char* packet = OSCPacketWriter::CreateForString(messageString.toLatin1().data(), outSize);
-	sendMessageData(packet, outSize);
+    OSCPacketWriter* packetWriter = OSCPacketWriter::CreatePacketWriterForString(messageString.toLatin1().data());
+    if (!packetWriter) return;
+    sendImmediately(*packetWriter);
+    delete packetWriter;
 
 	// Log if logging of outgoing messages is enabled:
     addToLog(true, messageString);
@@ -178,11 +201,9 @@ void OSCNetworkManager::sendMessage(QString path, QString argument, bool forced)
 {
     if (!m_isEnabled && !forced) return;
 
-    size_t outSize = 0;
 	OSCPacketWriter packetWriter(path.toStdString());
 	packetWriter.AddString(argument.toStdString());
-	char* packet = packetWriter.Create(outSize);
-	sendMessageData(packet, outSize);
+	sendImmediately(packetWriter);
 
 	// Log if logging of outgoing messages is enabled:
     addToLog(true, path + "=" + argument);
@@ -192,11 +213,9 @@ void OSCNetworkManager::sendMessage(QString path, double argument, bool forced)
 {
     if (!m_isEnabled && !forced) return;
 
-    size_t outSize = 0;
     OSCPacketWriter packetWriter(path.toStdString());
     packetWriter.AddFloat64(argument);
-    char* packet = packetWriter.Create(outSize);
-    sendMessageData(packet, outSize);
+    sendImmediately(packetWriter);
 
     // Log if logging of outgoing messages is enabled:
     addToLog(true, path + "=" + QString::number(argument));
@@ -206,11 +225,9 @@ void OSCNetworkManager::sendMessage32bit(QString path, float argument, bool forc
 {
     if (!m_isEnabled && !forced) return;
 
-    size_t outSize = 0;
     OSCPacketWriter packetWriter(path.toStdString());
     packetWriter.AddFloat32(argument);
-    char* packet = packetWriter.Create(outSize);
-    sendMessageData(packet, outSize);
+    sendImmediately(packetWriter);
 
     // Log if logging of outgoing messages is enabled:
     addToLog(true, path + "=" + QString::number(double(argument)));
@@ -220,12 +237,10 @@ void OSCNetworkManager::sendMessage(QString path, qreal argument1, qreal argumen
 {
     if (!m_isEnabled && !forced) return;
 
-    size_t outSize = 0;
     OSCPacketWriter packetWriter(path.toStdString());
     packetWriter.AddFloat64(argument1);
     packetWriter.AddFloat64(argument2);
-    char* packet = packetWriter.Create(outSize);
-    sendMessageData(packet, outSize);
+    sendImmediately(packetWriter);
 
     // Log if logging of outgoing messages is enabled:
     addToLog(true, path + "=" + QString::number(argument1) + "," + QString::number(argument2));
@@ -235,17 +250,102 @@ void OSCNetworkManager::sendMessage(QString path, QString argument1, QString arg
 {
     if (!m_isEnabled && !forced) return;
 
-    size_t outSize;
     OSCPacketWriter packetWriter(path.toStdString());
     packetWriter.AddString(argument1.toStdString());
     packetWriter.AddString(argument2.toStdString());
-    char* packet = packetWriter.Create(outSize);
-    sendMessageData(packet, outSize);
+    sendImmediately(packetWriter);
 
     // Log if logging of outgoing messages is enabled:
     addToLog(true, path + "=" + argument1 + "," + argument2);
 }
 
+void OSCNetworkManager::sendCoalescedMessage(QString path, double argument, bool forced)
+{
+    if (!m_isEnabled && !forced) return;
+
+    OSCPacketWriter packetWriter(path.toStdString());
+    packetWriter.AddFloat64(argument);
+    queueMessage(packetWriter, /*coalesce*/ true);
+
+    // Log if logging of outgoing messages is enabled:
+    addToLog(true, path + "=" + QString::number(argument));
+}
+
+void OSCNetworkManager::sendCoalescedMessage32bit(QString path, float argument, bool forced)
+{
+    if (!m_isEnabled && !forced) return;
+
+    OSCPacketWriter packetWriter(path.toStdString());
+    packetWriter.AddFloat32(argument);
+    queueMessage(packetWriter, /*coalesce*/ true);
+
+    // Log if logging of outgoing messages is enabled:
+    addToLog(true, path + "=" + QString::number(double(argument)));
+}
+
+void OSCNetworkManager::sendCoalescedMessage(QString path, qreal argument1, qreal argument2, bool forced)
+{
+    if (!m_isEnabled && !forced) return;
+
+    OSCPacketWriter packetWriter(path.toStdString());
+    packetWriter.AddFloat64(argument1);
+    packetWriter.AddFloat64(argument2);
+    queueMessage(packetWriter, /*coalesce*/ true);
+
+    // Log if logging of outgoing messages is enabled:
+    addToLog(true, path + "=" + QString::number(argument1) + "," + QString::number(argument2));
+}
+
+void OSCNetworkManager::flushOutgoingMessages()
+{
+    if (m_outgoingMessages.isEmpty()) return;
+
+    // check if TCP socket is connected, otherwise the messages are discarded:
+    if (!m_useTcp || m_tcpSocket.state() == QAbstractSocket::ConnectedState) {
+        // Eos supports bundles, for other devices the messages are sent one by one:
+        const bool useBundles = m_currentConnectionType == OscConnectionType::Eos;
+        const int maxBundleSize = m_useTcp ? MAX_TCP_BUNDLE_SIZE : MAX_UDP_BUNDLE_SIZE;
+        m_outgoingTcpFrames.resize(0);
+        int messageCount = 0;
+
+        for (const OutgoingMessage& message: m_outgoingMessages) {
+            ++messageCount;
+            const char* data = m_outgoingData.constData() + message.offset;
+            if (!useBundles) {
+                sendPacket(data, message.size);
+                continue;
+            }
+            // each bundle element is the size as int32 followed by the message:
+            if (m_outgoingBundleCount && m_outgoingBundle.size() + 4 + message.size > maxBundleSize) {
+                sendBundle();
+            }
+            if (m_outgoingBundleCount == 0) {
+                m_outgoingBundle.resize(0);
+                m_outgoingBundle.append(BUNDLE_HEADER, BUNDLE_HEADER_SIZE);
+            }
+            int32_t elementSize = message.size;
+            OSCArgument::Swap32(&elementSize);
+            m_outgoingBundle.append(reinterpret_cast<const char*>(&elementSize), sizeof(elementSize));
+            m_outgoingBundle.append(data, message.size);
+            ++m_outgoingBundleCount;
+        }
+        if (m_outgoingBundleCount) sendBundle();
+
+        // write all TCP frames of this frame at once:
+        if (!m_outgoingTcpFrames.isEmpty()) {
+            m_tcpSocket.write(m_outgoingTcpFrames);
+            m_telemetry.addOutgoingBytes(m_outgoingTcpFrames.size());
+        }
+        m_telemetry.addOutgoingMessages(messageCount);
+        m_telemetry.updateQueueDepth(messageCount, m_useTcp ? m_tcpSocket.bytesToWrite() : 0);
+        emit packetSent();
+    }
+
+    m_outgoingData.resize(0);
+    m_outgoingMessages.resize(0);
+    m_coalescedMessageIndexes.clear();
+}
+
 QStringList OSCNetworkManager::getProtocolNames() const
 {
     return QStringList {OscProtocol::UDP, OscProtocol::TCP_1_0, OscProtocol::TCP_1_1};
@@ -283,119 +383,83 @@ void OSCNetworkManager::setState(const QJsonObject &state) {
     }
 }
 
-void OSCNetworkManager::sendMessageData(char* packet, size_t outSize)
+void OSCNetworkManager::queueMessage(const OSCPacketWriter& packetWriter, bool coalesce)
 {
-    // send packet either with UDP or TCP:
-    if (m_useTcp) {
-        // check if TCP socket is connected:
-        if (m_tcpSocket.state() == QAbstractSocket::ConnectedState) {
-            // socket is connected
-            // for TCP transmission the packet has to be framed:
-            char* framedPacket = OSCStream::CreateFrame(m_tcpFrameMode, packet, outSize);
-            m_tcpSocket.write(framedPacket, qint64(outSize));
-            delete[] framedPacket;
-        }
-    } else {
-        // use UDP:
-        m_udpSocket.writeDatagram(packet, qint64(outSize), m_ipAddress, m_udpTxPort);
+    // write the message directly to the end of the queued data:
+    const int size = int(packetWriter.ComputeSize());
+    if (size <= 0) return;
+    const int offset = m_outgoingData.size();
+    m_outgoingData.resize(offset + size);
+    if (!packetWriter.Write(m_outgoingData.data() + offset, size_t(size))) {
+        m_outgoingData.resize(offset);
+        return;
     }
 
-    delete[] packet;
-    emit packetSent();
+    if (coalesce) {
+        // last value wins, but the message keeps the position of the first one with this path,
+        // so that the order relative to other messages doesn't change:
+        const QByteArray path = QByteArray::fromStdString(packetWriter.GetPath());
+        auto it = m_coalescedMessageIndexes.find(path);
+        if (it != m_coalescedMessageIndexes.end()) {
+            m_outgoingMessages[it.value()] = OutgoingMessage {offset, size};
+            return;
+        }
+        m_coalescedMessageIndexes.insert(path, m_outgoingMessages.size());
+    }
+    m_outgoingMessages.append(OutgoingMessage {offset, size});
 }
 
-QByteArray OSCNetworkManager::popPacketFromStreamData(QByteArray& data) const
+void OSCNetworkManager::sendImmediately(const OSCPacketWriter& packetWriter)
 {
-	if (m_tcpFrameMode == OSCStream::FRAME_MODE_1_0) {
-		return popPacketLengthFramedPacketFromStreamData(data);
-	} else {
-		return popSlipFramedPacketFromStreamData(data);
-	}
+    // the messages queued before are sent first to keep the order:
+    queueMessage(packetWriter, /*coalesce*/ false);
+    flushOutgoingMessages();
 }
 
-QByteArray OSCNetworkManager::popPacketLengthFramedPacketFromStreamData(QByteArray& tcpData) const
+void OSCNetworkManager::sendPacket(const char* packet, int size)
 {
-	// the first 4 bytes are the length of the OSC message following as an int32:
-	int32_t messageLength = reinterpret_cast<int32_t*>(tcpData.data())[0];
-	// adjust the network byte order (?):
-	OSCArgument::Swap32(&messageLength);
-
-	// check if the messageLength is in the range of a valid message:
-	if (messageLength <= 0 || messageLength > 512) {
-		// this is not a valid OSC message
-		// received data will be discarded:
-		addToLog(false, "Invalid data received (message length in TCP packet is out of range). Check Protocol Settings.");
-		tcpData.resize(0);
-		return QByteArray();
-	}
-
-	// check if the message is completely received:
-	if (messageLength > tcpData.size()) {
-		// the message length is greater than the size of the data received
-		// so there is nothing to pop / return yet:
-		return QByteArray();
-	}
-
-	// create a new QByteArray containing only the OSC message data:
-	QByteArray messageData = QByteArray(tcpData.data() + sizeof(messageLength), messageLength);
-	// remove the messageLength and the message data from the received data:
-    tcpData.remove(0, messageLength + int(sizeof(messageLength)));
+    // send packet either with UDP or TCP:
+    if (!m_useTcp) {
+        m_udpSocket.writeDatagram(packet, qint64(size), m_ipAddress, m_udpTxPort);
+        m_telemetry.addOutgoingBytes(size);
+        return;
+    }
 
-	return messageData;
+    // for TCP transmission the packet has to be framed:
+    if (m_tcpFrameMode == OSCStream::FRAME_MODE_1_0) {
+        // OSC 1.0: size of the packet as int32 before the packet
+        int32_t packetSize = size;
+        OSCArgument::Swap32(&packetSize);
+        m_outgoingTcpFrames.append(reinterpret_cast<const char*>(&packetSize), sizeof(packetSize));
+        m_outgoingTcpFrames.append(packet, size);
+    } else {
+        // OSC 1.1: SLIP encoded with END characters before and after the packet
+        m_outgoingTcpFrames.append(SLIP_END);
+        for (int i=0; i<size; ++i) {
+            if (packet[i] == SLIP_END) {
+                m_outgoingTcpFrames.append(SLIP_ESC);
+                m_outgoingTcpFrames.append(SLIP_ESC_END);
+            } else if (packet[i] == SLIP_ESC) {
+                m_outgoingTcpFrames.append(SLIP_ESC);
+                m_outgoingTcpFrames.append(SLIP_ESC_ESC);
+            } else {
+                m_outgoingTcpFrames.append(packet[i]);
+            }
+        }
+        m_outgoingTcpFrames.append(SLIP_END);
+    }
 }
 
-QByteArray OSCNetworkManager::popSlipFramedPacketFromStreamData(QByteArray& tcpData) const
+void OSCNetworkManager::sendBundle()
 {
-	// A SLIP framed packet begins and ends with a SLIP END character.
-
-	// find first SLIP END character:
-	// most probably it is the first character:
-	int firstSlipEndPosition = 0;
-	if (tcpData[0] != SLIP_CHAR(SLIP_END)) {
-		for (int i=1; i<tcpData.size(); ++i) {
-			if (tcpData[i] == SLIP_CHAR(SLIP_END)) {
-				firstSlipEndPosition = i;
-				break;
-			}
-		}
-		if (firstSlipEndPosition == 0) {
-			// if first slip end postion is still 0,
-			// this means there is no SLIP END character in the data
-			// -> discard the data and return nothing:
-			addToLog(false, "[In] Invalid data received (missing SLIP END character). Check Protocol Settings.");
-			tcpData.resize(0);
-			return QByteArray();
-		}
-	}
-
-	// find second SLIP END character:
-	int secondSlipEndPosition = -1;
-	for (int i=firstSlipEndPosition+1; i<tcpData.size(); ++i) {
-		if (tcpData[i] == SLIP_CHAR(SLIP_END)) {
-			secondSlipEndPosition = i;
-			break;
-		}
-	}
-	if (secondSlipEndPosition < 0) {
-		// there is no second SLIP END character
-		// -> message is not yet complete:
-		return QByteArray();
-	}
-
-	// at this point we should have found two SLIP END characters
-	Q_ASSERT(secondSlipEndPosition > firstSlipEndPosition);
-
-	int messageLength = secondSlipEndPosition - firstSlipEndPosition - 1;
-	// create a new QByteArray containing only the OSC message data:
-	QByteArray messageData = QByteArray(tcpData.data() + firstSlipEndPosition + 1, messageLength);
-	// remove everything before the second SLIP END from the received data:
-	tcpData.remove(0, secondSlipEndPosition + 1);
-
-	// replace characters that have been escaped because of SLIP framing:
-	messageData.replace(SLIP_CHAR(SLIP_ESC) + SLIP_CHAR(SLIP_ESC_END), SLIP_CHAR(SLIP_END));
-	messageData.replace(SLIP_CHAR(SLIP_ESC) + SLIP_CHAR(SLIP_ESC_ESC), SLIP_CHAR(SLIP_ESC));
-
-	return messageData;
+    if (m_outgoingBundleCount == 1) {
+        // a bundle with a single message is not necessary:
+        const int elementStart = BUNDLE_HEADER_SIZE + 4;
+        sendPacket(m_outgoingBundle.constData() + elementStart, m_outgoingBundle.size() - elementStart);
+    } else {
+        sendPacket(m_outgoingBundle.constData(), m_outgoingBundle.size());
+    }
+    m_outgoingBundleCount = 0;
 }
 
 void OSCNetworkManager::addToLog(bool out, QString text) const
@@ -422,12 +486,16 @@ void OSCNetworkManager::tryToConnectTCP()
 
 void OSCNetworkManager::onConnected()
 {
+	// a new stream starts:
+	m_tcpDeframer.clear();
+	m_telemetry.addConnectionEstablished();
 	emit isConnectedChanged();
 }
 
 void OSCNetworkManager::onError()
 {
 	emit isConnectedChanged();
+	m_telemetry.addConnectionError();
 	addToLog(true, "TCP Error: " + m_tcpSocket.errorString());
 
 	// try again if user still wants to use TCP:
@@ -453,108 +521,109 @@ void OSCNetworkManager::enableLogging(bool incoming, bool outgoing)
 void OSCNetworkManager::readIncomingUdpDatagrams()
 {
 	while (m_udpSocket.hasPendingDatagrams()) {
-		// prepare empty variables to be written in:
-		QByteArray datagram;
-        datagram.resize(int(m_udpSocket.pendingDatagramSize()));
-		QHostAddress sender;
-		quint16 senderPort;
-
-		// get data from socket:
-		m_udpSocket.readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
+		// read the datagram into the reused buffer:
+		const int pendingSize = int(m_udpSocket.pendingDatagramSize());
+		if (pendingSize > m_udpReceiveBuffer.size()) {
+			m_udpReceiveBuffer.resize(pendingSize);
+		}
+		const qint64 size = m_udpSocket.readDatagram(m_udpReceiveBuffer.data(), m_udpReceiveBuffer.size());
+		if (size <= 0) continue;
+		m_telemetry.addIncomingBytes(int(size));
 
 		// process data:
-		processIncomingRawData(datagram);
+		processIncomingRawData(m_udpReceiveBuffer.constData(), int(size));
 	}
 }
 
 void OSCNetworkManager::readIncomingTcpStream()
 {
-    const QByteArray newStreamData = m_tcpSocket.readAll();
-    QByteArray streamData = newStreamData;
-
-	// check if there is incomplete stream data left from last call:
-    bool usingIncompleteStreamData = false;
-    if (!m_incompleteStreamData.isEmpty()) {
-        streamData = m_incompleteStreamData + newStreamData;
-        m_incompleteStreamData.clear();
-        usingIncompleteStreamData = true;
-    }
-
-    int packetCount = 0;
-
-	// as long as there is stream data left:
-	while (streamData.size()) {
-		// try to get a complete packet from the stream data:
-		QByteArray packet = popPacketFromStreamData(streamData);
-
-        if (packet.isEmpty()) {
-
-            if (packetCount < 1 && usingIncompleteStreamData) {
-                // couldn't even get one package,
-                // try parsing only new data:
-                QByteArray newData = newStreamData;
-                QByteArray packet = popPacketFromStreamData(newData);
-                if (!packet.isEmpty()) {
-                    // successfully got packet from only new data,
-                    // there seems to be a problem with the incomplete data:
-                    m_incompleteStreamData.clear();
-                    streamData = newStreamData;
-                    usingIncompleteStreamData = false;
-                    continue;
-                }
-            }
-
-			// there is no more complete packet
-			// but maybe there is incomplete packet data left:
-			m_incompleteStreamData = streamData;
-			return;
+	while (m_tcpSocket.bytesAvailable() > 0) {
+		// read directly into the buffer of the deframer:
+		size_t available = 0;
+		char* buffer = m_tcpDeframer.getWriteBuffer(available);
+		const qint64 size = m_tcpSocket.read(buffer, qint64(available));
+		if (size <= 0) return;
+		m_tcpDeframer.commitWrite(size_t(size));
+		m_telemetry.addIncomingBytes(int(size));
+
+		// process all complete packets,
+		// the rest stays in the deframer until more data arrives:
+		const char* packet = nullptr;
+		size_t packetSize = 0;
+		OSCStreamDeframer::Result result;
+		while ((result = m_tcpDeframer.nextPacket(packet, packetSize)) != OSCStreamDeframer::NO_PACKET) {
+			if (result == OSCStreamDeframer::INVALID_DATA) {
+				m_telemetry.addParseError();
+				addToLog(false, "Invalid data received (packet length in TCP stream is out of range). Check Protocol Settings.");
+				continue;
+			}
+			processIncomingRawData(packet, int(packetSize));
 		}
-
-		processIncomingRawData(packet);
-        ++packetCount;
 	}
 }
 
-void OSCNetworkManager::processIncomingRawData(QByteArray msgData)
+void OSCNetworkManager::processIncomingRawData(const char* data, int size)
 {
+	if (size <= 0) return;
+
 	// check if the data is a single message or a bundle of messages:
-	if (msgData[0] == '/') {
+	if (data[0] == '/') {
 		// it starts with a "/" -> it is a single message:
-		processIncomingRawMessage(msgData);
-	} else if (msgData.startsWith("#bundle")) {
+		processIncomingRawMessage(data, size);
+	} else if (size >= BUNDLE_HEADER_SIZE && memcmp(data, "#bundle", 8) == 0) {
 		// it starts with "#bundle" -> it is a bundle
-		// remove "#bundle" string (8 bytes) and unused timetag (8 bytes):
-		msgData.remove(0, 16);
-		// try to get all messages in the bundle:
-		while (msgData.size()) {
-			// each message starts with the length of the message as int32
-			// this is the same as a TCP 1.0 packet, so the function for that can be used:
-			QByteArray message = popPacketLengthFramedPacketFromStreamData(msgData);
-			// process the message:
-            processIncomingRawData(message);
+		// skip "#bundle" string (8 bytes) and unused timetag (8 bytes):
+		int position = BUNDLE_HEADER_SIZE;
+		// process all elements of the bundle in place:
+		while (position + int(sizeof(int32_t)) <= size) {
+			// each element starts with its length as int32:
+			int32_t elementLength;
+			memcpy(&elementLength, data + position, sizeof(elementLength));
+			OSCArgument::Swap32(&elementLength);
+			position += int(sizeof(elementLength));
+
+			if (elementLength <= 0 || elementLength > size - position) {
+				m_telemetry.addParseError();
+				addToLog(false, "[Invalid] Bundle element length is out of range.");
+				return;
+			}
+			// process the element (message or bundle):
+			processIncomingRawData(data + position, elementLength);
+			position += elementLength;
 		}
 	} else {
 		// invalid data
-		addToLog(false, "[Invalid] Raw: " + QString::fromLatin1(msgData.data(), msgData.size()));
+		m_telemetry.addParseError();
+		addToLog(false, "[Invalid] Raw: " + QString::fromLatin1(data, size));
 	}
 }
 
-void OSCNetworkManager::processIncomingRawMessage(QByteArray msgData)
+void OSCNetworkManager::processIncomingRawMessage(const char* data, int size)
 {
 	// build an OSC message from the data:
-	OSCMessage msg(msgData);
+	OSCMessage msg(data, size);
+
+	// Log if logging of incoming messages is enabled
+	// (the log string is only created if necessary):
+	if (m_logIncomingMsg) {
+		if (msg.isValid()) {
+			addToLog(false, msg.pathString() + msg.getArgumentsAsDebugString());
+		} else {
+			addToLog(false, "[Invalid] Raw: " + QString::fromLatin1(data, size));
+		}
+	}
 
-	// Log if logging of incoming messages is enabled:
 	if (msg.isValid()) {
-		addToLog(false, msg.pathString() + msg.getArgumentsAsDebugString());
+		m_telemetry.addIncomingMessage();
 	} else {
-		addToLog(false, "[Invalid] Raw: " + QString::fromLatin1(msgData.data(), msgData.size()));
+		m_telemetry.addParseError();
 	}
 
 	// emit message received signal:
 	if (msg.isValid()) {
         if (m_isEnabled) {
             emit messageReceived(msg);
+            m_router.dispatch(msg);
         } else {
             emit messageReceivedWhileDisabled(msg);
         }
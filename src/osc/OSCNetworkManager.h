@@ -3,6 +3,9 @@
 
 #include "OSCParser.h"
 #include "OSCMessage.h"
+#include "OSCStreamDeframer.h"
+#include "OSCRouter.h"
+#include "OSCConnectionTelemetry.h"
 #include "utils.h"
 
 #include <QObject>
@@ -42,6 +45,18 @@ static const quint16 DEFAULT_UDP_RX_PORT = 8000;
  */
 static const int MAX_LOG_LENGTH = 1000;
 
+/**
+ * @brief maximum size of an outgoing bundle sent via UDP (to prevent IP fragmentation)
+ * @memberof OSCNetworkManager
+ */
+static const int MAX_UDP_BUNDLE_SIZE = 1400;
+
+/**
+ * @brief maximum size of an outgoing bundle sent via TCP
+ * @memberof OSCNetworkManager
+ */
+static const int MAX_TCP_BUNDLE_SIZE = 32768;
+
 namespace OscProtocol {
 static const QString UDP = "UDP";
 static const QString TCP_1_0 = "TCP 1.0";
@@ -61,6 +76,13 @@ static const QString Custom = "Custom";
  * @brief The OSCNetworkManager class manages OSC data exchange.
  * It can send and receive OSC messages via UDP and TCP
  * and supports OSC 1.0 and 1.1 packet-framing.
+ *
+ * Messages sent with sendMessage() are sent immediately. Absolute values sent with
+ * sendCoalescedMessage() are queued and sent once per frame by flushOutgoingMessages(),
+ * so that only the last value of a path is sent. Queued messages are sent before the next
+ * immediate message to keep the order. They are sent as OSC bundles if the connection type supports them.
+ *
+ * The traffic, the outgoing queue, reconnects and parse errors are recorded by telemetry().
  */
 class OSCNetworkManager : public QObject {
 
@@ -81,9 +103,22 @@ public:
     // declare EosOSCManager as friend to be able to call for example reconnect():
     friend class EosOSCManager;
 
+    /**
+     * @brief router returns the router to register handlers for specific OSC addresses,
+     * it is used instead of messageReceived() when only a few addresses are of interest
+     * @return the router of incoming messages
+     */
+    OSCRouter* router() { return &m_router; }
+
 
 public slots:
 
+    /**
+     * @brief telemetry returns the statistics of this connection
+     * @return a pointer to the OSCConnectionTelemetry object
+     */
+    OSCConnectionTelemetry* telemetry() { return &m_telemetry; }
+
     // --------------------- Presets ------------------------
 
     QStringList getAvailableTypes() const { return m_availableTypes; }
@@ -220,6 +255,41 @@ public slots:
      */
     void sendMessage(QString path, QString argument1, QString argument2, bool forced = false);
 
+    /**
+     * @brief Sends an OSC message with a 64-bit double as the only argument.
+     * A message with the same path that is not yet sent in this frame is replaced (last value wins).
+     * Use it for absolute values like fader levels, not for relative values or buttons.
+     * @param path of the message
+     * @param argument a double to be sent as the only argument
+     * @param forced true to send message even if OSC output is disabled
+     */
+    void sendCoalescedMessage(QString path, double argument, bool forced = false);
+
+    /**
+     * @brief Sends an OSC message with a 32-bit float as the only argument.
+     * A message with the same path that is not yet sent in this frame is replaced (last value wins).
+     * @param path of the message
+     * @param argument a float to be sent as the only argument
+     * @param forced true to send message even if OSC output is disabled
+     */
+    void sendCoalescedMessage32bit(QString path, float argument, bool forced = false);
+
+    /**
+     * @brief Sends an OSC message with two floats as the arguments.
+     * A message with the same path that is not yet sent in this frame is replaced (last value wins).
+     * @param path of the message
+     * @param argument1 a float to be sent as the first argument
+     * @param argument2 a float to be sent as the second argument
+     * @param forced true to send message even if OSC output is disabled
+     */
+    void sendCoalescedMessage(QString path, qreal argument1, qreal argument2, bool forced = false);
+
+    /**
+     * @brief flushOutgoingMessages sends all messages queued in this frame,
+     * called by the engine after each frame
+     */
+    void flushOutgoingMessages();
+
 
 	// ------------------- Persistence --------------------
 
@@ -276,39 +346,31 @@ protected:
     // ------------------- Private / Internal --------------------
 
 	/**
-	 * @brief sendMessageData sends raw OSC message data
-	 * @param packet OSC message as an array of chars
-	 * @param outSize size of the packet
+	 * @brief queueMessage adds a message to the queue of messages sent at the end of the frame
+	 * @param packetWriter the message to send
+	 * @param coalesce true to replace a queued message with the same path (at its position)
 	 */
-	void sendMessageData(char* packet, size_t outSize);
+	void queueMessage(const OSCPacketWriter& packetWriter, bool coalesce);
 
 	/**
-	 * @brief popPacketFromStreamData returns and removes the
-	 * raw OSC message data from a framed packet in a TCP stream
-	 * or returns nothing if the OSC message is not yet complete.
-	 * Discards the data if it is invalid.
-	 * @param data the incoming stream data (will be modified)
-	 * @return the data of a single OSC message
+	 * @brief sendImmediately sends a message (i.e. a command) without waiting for the end of the frame,
+	 * the queued messages are sent before it
+	 * @param packetWriter the message to send
 	 */
-	QByteArray popPacketFromStreamData(QByteArray& data) const;
+	void sendImmediately(const OSCPacketWriter& packetWriter);
+
 	/**
-	 * @brief returns and removes the raw OSC message data from
-	 * a "packet-length-framed" packet in a TCP stream
-	 * or returns nothing if the OSC message is not yet complete.
-	 * Discards the data if it is invalid.
-	 * @param data the incoming stream data (will be modified)
-	 * @return the data of a single OSC packet (could be a bundle or message)
+	 * @brief sendPacket sends a raw OSC packet via UDP or adds it to the TCP frames to write
+	 * @param packet OSC message or bundle
+	 * @param size size of the packet
 	 */
-	QByteArray popPacketLengthFramedPacketFromStreamData(QByteArray& data) const;
+	void sendPacket(const char* packet, int size);
+
 	/**
-	 * @brief returns and removes the raw OSC message data from
-	 * a SLIP framed packet in a TCP stream
-	 * or returns nothing if the OSC message is not yet complete.
-	 * Discards the data if it is invalid.
-	 * @param data the incoming stream data (will be modified)
-	 * @return the data of a single OSC packet (could be a bundle or message)
+	 * @brief sendBundle sends the bundle in m_outgoingBundle,
+	 * or only its message if it contains a single one
 	 */
-	QByteArray popSlipFramedPacketFromStreamData(QByteArray& data) const;
+	void sendBundle();
 
 	/**
 	 * @brief addToLog adds a text to the log
@@ -345,17 +407,22 @@ private slots:
 	 */
 	void readIncomingTcpStream();
 
+protected:
+
 	/**
-	 * @brief processIncomingRawData processes incoming raw data and checks if it is an OSC bundle
-	 * @param msgData raw OSC packet data (bundle or message)
+	 * @brief processIncomingRawData processes incoming raw data and checks if it is an OSC bundle.
+	 * The data is only read, messages in bundles are processed in place.
+	 * @param data pointer to raw OSC packet data (bundle or message)
+	 * @param size size of the data in bytes
 	 */
-	void processIncomingRawData(QByteArray msgData);
+	void processIncomingRawData(const char* data, int size);
 
 	/**
 	 * @brief processIncomingRawMessage processes incoming single raw OSC messages
-	 * @param msgData raw OSC message data (not a bundle)
+	 * @param data pointer to raw OSC message data (not a bundle)
+	 * @param size size of the data in bytes
 	 */
-	void processIncomingRawMessage(QByteArray msgData);
+	void processIncomingRawMessage(const char* data, int size);
 
 private:
     QStringList m_availableTypes;
@@ -411,10 +478,55 @@ private:
 	 */
     bool					m_logOutgoingMsg;
 	/**
-	 * @brief m_incompleteStreamData may contain the begin of an incomplete OSC packet
-	 * (from TCP stream)
+	 * @brief m_tcpDeframer splits the TCP stream into OSC packets,
+	 * it may contain the begin of an incomplete OSC packet
+	 */
+	OSCStreamDeframer		m_tcpDeframer;
+	/**
+	 * @brief m_router dispatches incoming messages to the handlers registered for their address
+	 */
+	OSCRouter				m_router;
+	/**
+	 * @brief m_telemetry collects the statistics of this connection
+	 */
+	OSCConnectionTelemetry	m_telemetry;
+	/**
+	 * @brief m_udpReceiveBuffer is reused to read all incoming UDP datagrams
+	 */
+	QByteArray				m_udpReceiveBuffer;
+
+	/**
+	 * @brief The OutgoingMessage struct describes a queued message in m_outgoingData
+	 */
+	struct OutgoingMessage {
+		int offset;
+		int size;
+	};
+	/**
+	 * @brief m_outgoingData contains the data of all messages queued in this frame
+	 */
+	QByteArray				m_outgoingData;
+	/**
+	 * @brief m_outgoingMessages are the messages in m_outgoingData in the order they are sent
+	 */
+	QVector<OutgoingMessage> m_outgoingMessages;
+	/**
+	 * @brief m_coalescedMessageIndexes maps the path of a coalesced message to its index
+	 * in m_outgoingMessages
+	 */
+	QHash<QByteArray, int>	m_coalescedMessageIndexes;
+	/**
+	 * @brief m_outgoingBundle is the bundle currently assembled by flushOutgoingMessages()
+	 */
+	QByteArray				m_outgoingBundle;
+	/**
+	 * @brief m_outgoingBundleCount is the number of messages in m_outgoingBundle
+	 */
+	int						m_outgoingBundleCount;
+	/**
+	 * @brief m_outgoingTcpFrames contains the framed packets to be written to the TCP socket at once
 	 */
-	QByteArray				m_incompleteStreamData;
+	QByteArray				m_outgoingTcpFrames;
 
     /**
      * @brief m_logChangedSignalDelay is a timer to delay the emission of the logChanged signal
@@ -966,6 +966,37 @@ OSCArgument* OSCArgument::GetArgs(char *buf, size_t size, size_t &count)
     count = 0;
 
     if(requestedCount!=0 && buf && size!=0)
+    {
+        // find the number of arguments first
+        size_t noArgs = 0;
+        size_t argCount = GetArgs(buf, size, 0, noArgs);
+
+        if(requestedCount > argCount)
+            requestedCount = argCount;
+
+        if(requestedCount != 0)
+        {
+            args = new OSCArgument[requestedCount];
+            count = requestedCount;
+            GetArgs(buf, size, args, count);
+        }
+    }
+
+    return args;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Fills the given args (without allocating), count is their capacity on input and the
+// number of parsed arguments on output. Returns the number of arguments in the type tag string.
+size_t OSCArgument::GetArgs(char *buf, size_t size, OSCArgument *args, size_t &count)
+{
+    size_t requestedCount = count;
+    size_t argCount = 0;
+
+    count = 0;
+
+    if(buf && size!=0)
     {
         const char *bufEnd = &buf[size-1];
 
@@ -982,7 +1013,6 @@ OSCArgument* OSCArgument::GetArgs(char *buf, size_t size, size_t &count)
             // now typeTag should point to the string with the list of OSC argument types, ex: "ii"
 
             // find where the binary data starts, after the type tag string null terminator (32-bit aligned)
-            size_t argCount = 0;
             char *binaryData = typeTag;
             do
             {
@@ -998,13 +1028,12 @@ OSCArgument* OSCArgument::GetArgs(char *buf, size_t size, size_t &count)
             if(requestedCount > argCount)
                 requestedCount = argCount;
 
-            if(requestedCount != 0)
+            if(args && requestedCount != 0)
             {
                 if(binaryData > bufEnd)
                     binaryData = 0;	// still invalid, some OSC types do not have any binary data
 
                 // now binaryData should point to the first argument's binary data
-                args = new OSCArgument[requestedCount];
                 for(; count<requestedCount; count++)
                 {
                     OSCArgument::EnumArgumentTypes argType = OSCArgument::GetArgumentTypeFromChar( typeTag[count] );
@@ -1027,7 +1056,7 @@ OSCArgument* OSCArgument::GetArgs(char *buf, size_t size, size_t &count)
         }
     }
 
-    return args;
+    return argCount;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -169,6 +169,7 @@ public:
 	bool GetBool(bool &b) const;
 
 	static OSCArgument* GetArgs(char *buf, size_t size, size_t &count);
+	static size_t GetArgs(char *buf, size_t size, OSCArgument *args, size_t &count);
 	static EnumArgumentTypes GetArgumentTypeFromChar(char c);
 	static char GetCharFromArgumentType(EnumArgumentTypes type);
 	static char* Get32BitAligned(char *start, char *p);
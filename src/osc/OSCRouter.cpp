@@ -0,0 +1,310 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "OSCRouter.h"
+
+#include <QVarLengthArray>
+#include <QDebug>
+#include <algorithm>
+
+
+OSCRouter::OSCRouter(QObject* parent)
+	: QObject(parent)
+	, m_root(new Node())
+	, m_routes()
+	, m_patternRoutes()
+	, m_receivers()
+	, m_lastRouteId(0)
+{
+
+}
+
+OSCRouter::~OSCRouter()
+{
+	deleteNode(m_root);
+}
+
+int OSCRouter::addRoute(const QString& address, QObject* receiver, Handler handler)
+{
+	return addRoute(isPattern(address) ? PATTERN : EXACT, address, receiver, handler);
+}
+
+int OSCRouter::addPrefixRoute(const QString& prefix, QObject* receiver, Handler handler)
+{
+	return addRoute(PREFIX, prefix, receiver, handler);
+}
+
+int OSCRouter::addRoute(RouteType type, const QString& address, QObject* receiver, Handler handler)
+{
+	if (!address.startsWith(QLatin1Char('/'))) {
+		qWarning() << "OSC address doesn't begin with a slash, route is ignored:" << address;
+		return 0;
+	}
+
+	Route route;
+	route.type = type;
+	route.address = address;
+	route.parts = splitAddress(address);
+	if (type == PREFIX && !route.parts.isEmpty() && route.parts.last().isEmpty()) {
+		// a trailing slash doesn't matter for a prefix:
+		route.parts.removeLast();
+	}
+	route.receiver = receiver;
+	route.handler = handler;
+
+	const int routeId = ++m_lastRouteId;
+	if (type == PATTERN) {
+		m_patternRoutes.append(routeId);
+	} else {
+		Node* node = getNode(route.parts, /*create*/ true);
+		if (type == EXACT) {
+			node->exactRoutes.append(routeId);
+		} else {
+			node->prefixRoutes.append(routeId);
+		}
+	}
+	m_routes.insert(routeId, route);
+
+	// remove the routes when the receiver is destroyed:
+	if (receiver && !m_receivers.contains(receiver)) {
+		m_receivers.insert(receiver);
+		connect(receiver, &QObject::destroyed, this, &OSCRouter::onReceiverDestroyed);
+	}
+	return routeId;
+}
+
+void OSCRouter::removeRoute(int routeId)
+{
+	auto it = m_routes.find(routeId);
+	if (it == m_routes.end()) return;
+
+	if (it->type == PATTERN) {
+		m_patternRoutes.removeAll(routeId);
+	} else {
+		Node* node = getNode(it->parts, /*create*/ false);
+		if (node) {
+			node->exactRoutes.removeAll(routeId);
+			node->prefixRoutes.removeAll(routeId);
+			pruneNodes(it->parts);
+		}
+	}
+	m_routes.erase(it);
+}
+
+void OSCRouter::removeRoutes(QObject* receiver)
+{
+	QVector<int> routeIds;
+	for (auto it = m_routes.cbegin(); it != m_routes.cend(); ++it) {
+		if (it->receiver == receiver) routeIds.append(it.key());
+	}
+	for (int routeId: routeIds) {
+		removeRoute(routeId);
+	}
+}
+
+void OSCRouter::dispatch(const OSCMessage& msg) const
+{
+	// collect the matching routes first, because handlers may add or remove routes:
+	QVarLengthArray<int, 16> matches;
+
+	// walk the tree along the parts of the address without splitting it into a list:
+	const QString& address = msg.pathString();
+	if (address.startsWith(QLatin1Char('/'))) {
+		const Node* node = m_root;
+		for (int routeId: node->prefixRoutes) matches.append(routeId);
+		const QChar slash = QLatin1Char('/');
+		const QChar* part = address.constData() + 1;
+		const QChar* end = address.constData() + address.size();
+		while (node) {
+			const QChar* partEnd = std::find(part, end, slash);
+			// fromRawData() doesn't copy the characters:
+			node = node->children.value(QString::fromRawData(part, int(partEnd - part)), nullptr);
+			if (!node) break;
+			for (int routeId: node->prefixRoutes) matches.append(routeId);
+			if (partEnd == end) {
+				for (int routeId: node->exactRoutes) matches.append(routeId);
+				break;
+			}
+			part = partEnd + 1;
+		}
+	}
+
+	for (int routeId: m_patternRoutes) {
+		auto it = m_routes.constFind(routeId);
+		if (it != m_routes.constEnd() && matchesPattern(it->address, msg.pathString())) {
+			matches.append(routeId);
+		}
+	}
+
+	for (int routeId: matches) {
+		auto it = m_routes.find(routeId);
+		if (it == m_routes.end()) continue;  // removed by a previous handler
+		// copy the handler, the route could be removed while it is called:
+		Handler handler = it->handler;
+		handler(msg);
+	}
+}
+
+bool OSCRouter::isPattern(const QString& address)
+{
+	for (const QChar& c: address) {
+		if (c == QLatin1Char('?') || c == QLatin1Char('*') || c == QLatin1Char('[') || c == QLatin1Char('{')) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool OSCRouter::matchesPattern(const QString& pattern, const QString& path)
+{
+	return matchesPattern(pattern.constData(), pattern.constData() + pattern.size(),
+						  path.constData(), path.constData() + path.size());
+}
+
+bool OSCRouter::matchesPattern(const QChar* pattern, const QChar* patternEnd,
+							   const QChar* path, const QChar* pathEnd)
+{
+	const QChar slash = QLatin1Char('/');
+	while (pattern < patternEnd) {
+		const QChar c = *pattern;
+
+		if (c == QLatin1Char('*')) {
+			// any sequence of characters in this part of the path:
+			while (pattern < patternEnd && *pattern == QLatin1Char('*')) ++pattern;
+			for (const QChar* p = path; p <= pathEnd; ++p) {
+				if (matchesPattern(pattern, patternEnd, p, pathEnd)) return true;
+				if (p < pathEnd && *p == slash) break;
+			}
+			return false;
+		}
+
+		if (path == pathEnd) return false;
+
+		if (c == QLatin1Char('?')) {
+			// any single character:
+			if (*path == slash) return false;
+			++pattern;
+			++path;
+		} else if (c == QLatin1Char('[')) {
+			// any character of a list or range:
+			++pattern;
+			bool negate = false;
+			if (pattern < patternEnd && *pattern == QLatin1Char('!')) {
+				negate = true;
+				++pattern;
+			}
+			bool matched = false;
+			while (pattern < patternEnd && *pattern != QLatin1Char(']')) {
+				if (pattern + 2 < patternEnd && pattern[1] == QLatin1Char('-') && pattern[2] != QLatin1Char(']')) {
+					if (*path >= pattern[0] && *path <= pattern[2]) matched = true;
+					pattern += 3;
+				} else {
+					if (*path == *pattern) matched = true;
+					++pattern;
+				}
+			}
+			if (pattern == patternEnd) return false;  // missing ]
+			++pattern;
+			if (matched == negate || *path == slash) return false;
+			++path;
+		} else if (c == QLatin1Char('{')) {
+			// one of the comma separated strings:
+			const QChar* close = pattern;
+			while (close < patternEnd && *close != QLatin1Char('}')) ++close;
+			if (close == patternEnd) return false;  // missing }
+			const QChar* option = pattern + 1;
+			while (option <= close) {
+				const QChar* optionEnd = option;
+				while (optionEnd < close && *optionEnd != QLatin1Char(',')) ++optionEnd;
+				const int length = int(optionEnd - option);
+				if (pathEnd - path >= length && std::equal(option, optionEnd, path)
+						&& matchesPattern(close + 1, patternEnd, path + length, pathEnd)) {
+					return true;
+				}
+				option = optionEnd + 1;
+			}
+			return false;
+		} else {
+			if (c != *path) return false;
+			++pattern;
+			++path;
+		}
+	}
+	return path == pathEnd;
+}
+
+void OSCRouter::onReceiverDestroyed(QObject* receiver)
+{
+	removeRoutes(receiver);
+	m_receivers.remove(receiver);
+}
+
+OSCRouter::Node* OSCRouter::getNode(const QStringList& parts, bool create) const
+{
+	Node* node = m_root;
+	for (const QString& part: parts) {
+		Node* child = node->children.value(part, nullptr);
+		if (!child) {
+			if (!create) return nullptr;
+			child = new Node();
+			node->children.insert(part, child);
+		}
+		node = child;
+	}
+	return node;
+}
+
+void OSCRouter::pruneNodes(const QStringList& parts)
+{
+	// collect the nodes along the path:
+	QVarLengthArray<Node*, 16> nodes;
+	Node* node = m_root;
+	nodes.append(node);
+	for (const QString& part: parts) {
+		node = node->children.value(part, nullptr);
+		if (!node) return;
+		nodes.append(node);
+	}
+	// remove nodes without routes and children, beginning at the end of the path:
+	for (int i = nodes.size() - 1; i > 0; --i) {
+		Node* child = nodes[i];
+		if (!child->children.isEmpty() || !child->exactRoutes.isEmpty() || !child->prefixRoutes.isEmpty()) {
+			break;
+		}
+		nodes[i - 1]->children.remove(parts[i - 1]);
+		delete child;
+	}
+}
+
+QStringList OSCRouter::splitAddress(const QString& address)
+{
+	// the address begins with a slash (see addRoute()), the empty part before it is removed:
+	QStringList parts = address.split(QLatin1Char('/'));
+	parts.removeFirst();
+	return parts;
+}
+
+void OSCRouter::deleteNode(Node* node)
+{
+	for (Node* child: node->children) {
+		deleteNode(child);
+	}
+	delete node;
+}
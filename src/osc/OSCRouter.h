@@ -0,0 +1,145 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef OSCROUTER_H
+#define OSCROUTER_H
+
+#include "OSCMessage.h"
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QStringList>
+#include <functional>
+
+
+/**
+ * @brief The OSCRouter class dispatches incoming OSC messages to the handlers
+ * registered for their address.
+ *
+ * Supported routes:
+ * - exact: the path has to be equal, i.e. "/hog/hardware/fader/3"
+ * - prefix: the path has to begin with the given parts, i.e. "/ch/01" matches "/ch/01/mix/fader"
+ * - pattern: an OSC address pattern with the wildcards ? * [abc] [a-z] [!abc] {foo,bar}
+ *
+ * Exact and prefix routes are stored in a tree of path parts, so a message only needs one
+ * lookup per path part, independent of the number of routes. Patterns are checked one by one.
+ * Addresses of routes and messages have to begin with a slash, others are ignored.
+ *
+ * A route is removed automatically when its receiver is destroyed.
+ */
+class OSCRouter : public QObject
+{
+	Q_OBJECT
+
+public:
+	typedef std::function<void(const OSCMessage&)> Handler;
+
+	explicit OSCRouter(QObject* parent = nullptr);
+	~OSCRouter();
+
+	/**
+	 * @brief addRoute adds an exact route or a pattern route if the address contains wildcards
+	 * @param address path or OSC address pattern
+	 * @param receiver the route is removed when this object is destroyed
+	 * @param handler function to be called with matching messages
+	 * @return route ID to be used with removeRoute() or 0 if the address doesn't begin with a slash
+	 */
+	int addRoute(const QString& address, QObject* receiver, Handler handler);
+
+	/**
+	 * @brief addPrefixRoute adds a route for all paths beginning with the parts of prefix
+	 * @param prefix beginning of the path, i.e. "/ch/01"
+	 * @param receiver the route is removed when this object is destroyed
+	 * @param handler function to be called with matching messages
+	 * @return route ID to be used with removeRoute() or 0 if the address doesn't begin with a slash
+	 */
+	int addPrefixRoute(const QString& prefix, QObject* receiver, Handler handler);
+
+	/**
+	 * @brief removeRoute removes a single route
+	 * @param routeId ID returned by an add method
+	 */
+	void removeRoute(int routeId);
+
+	/**
+	 * @brief removeRoutes removes all routes of a receiver
+	 * @param receiver object used when adding the routes
+	 */
+	void removeRoutes(QObject* receiver);
+
+	/**
+	 * @brief dispatch calls the handlers of all routes matching the message
+	 * @param msg incoming message
+	 */
+	void dispatch(const OSCMessage& msg) const;
+
+	/**
+	 * @brief isPattern returns if an address contains OSC wildcard characters
+	 * @param address path or OSC address pattern
+	 * @return true if it is a pattern
+	 */
+	static bool isPattern(const QString& address);
+
+	/**
+	 * @brief matchesPattern checks an OSC address pattern
+	 * @param pattern OSC address pattern
+	 * @param path the path of a message
+	 * @return true if the path matches the pattern
+	 */
+	static bool matchesPattern(const QString& pattern, const QString& path);
+
+private slots:
+	void onReceiverDestroyed(QObject* receiver);
+
+private:
+	enum RouteType { EXACT, PREFIX, PATTERN };
+
+	struct Route {
+		RouteType type;
+		QString address;
+		QStringList parts;
+		QObject* receiver;
+		Handler handler;
+	};
+
+	struct Node {
+		QHash<QString, Node*> children;
+		QVector<int> exactRoutes;
+		QVector<int> prefixRoutes;
+	};
+
+	int addRoute(RouteType type, const QString& address, QObject* receiver, Handler handler);
+	Node* getNode(const QStringList& parts, bool create) const;
+	void pruneNodes(const QStringList& parts);
+	static QStringList splitAddress(const QString& address);
+	static bool matchesPattern(const QChar* pattern, const QChar* patternEnd,
+							   const QChar* path, const QChar* pathEnd);
+	static void deleteNode(Node* node);
+
+	Node* m_root;
+	QHash<int, Route> m_routes;
+	QVector<int> m_patternRoutes;
+	QSet<QObject*> m_receivers;
+	int m_lastRouteId;
+};
+
+#endif // OSCROUTER_H
@@ -0,0 +1,249 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "OSCStreamDeframer.h"
+
+#include <cstring>
+#include <algorithm>
+
+// http://www.rfc-editor.org/rfc/rfc1055.txt
+#define SLIP_END		0xc0    /* indicates end of packet */
+#define SLIP_ESC		0xdb    /* indicates byte stuffing */
+#define SLIP_ESC_END	0xdc    /* ESC ESC_END means END data byte */
+#define SLIP_ESC_ESC	0xdd    /* ESC ESC_ESC means ESC data byte */
+
+#define SLIP_CHAR(x)	static_cast<char>(static_cast<unsigned char>(x))
+
+// initial size of the ring buffer, has to be a power of two:
+static const size_t INITIAL_CAPACITY = 65536;
+
+// a SLIP encoded packet can be up to twice as long as the packet:
+static const size_t MAX_SLIP_ENCODED_SIZE = 2 * size_t(OSCStream::MAX_FRAME_SIZE);
+
+
+OSCStreamDeframer::OSCStreamDeframer(OSCStream::EnumFrameMode frameMode)
+	: m_frameMode(frameMode)
+	, m_buffer(INITIAL_CAPACITY)
+	, m_mask(INITIAL_CAPACITY - 1)
+	, m_readPosition(0)
+	, m_writePosition(0)
+	, m_scanPosition(0)
+	, m_packetHasEscapes(false)
+	, m_discarding(false)
+	, m_packetBuffer()
+{
+
+}
+
+void OSCStreamDeframer::setFrameMode(OSCStream::EnumFrameMode frameMode)
+{
+	m_frameMode = frameMode;
+	clear();
+}
+
+void OSCStreamDeframer::clear()
+{
+	m_readPosition = 0;
+	m_writePosition = 0;
+	m_scanPosition = 0;
+	m_packetHasEscapes = false;
+	m_discarding = false;
+}
+
+char* OSCStreamDeframer::getWriteBuffer(size_t& available)
+{
+	if (bufferedSize() == m_buffer.size()) {
+		// buffer is full (a packet is longer than the buffer):
+		grow(m_buffer.size() * 2);
+	}
+	const size_t writeIndex = m_writePosition & m_mask;
+	const size_t freeSpace = m_buffer.size() - bufferedSize();
+	// only the contiguous part until the end of the buffer:
+	available = std::min(freeSpace, m_buffer.size() - writeIndex);
+	return m_buffer.data() + writeIndex;
+}
+
+void OSCStreamDeframer::commitWrite(size_t size)
+{
+	m_writePosition += size;
+}
+
+void OSCStreamDeframer::add(const char* data, size_t size)
+{
+	while (size) {
+		size_t available = 0;
+		char* buffer = getWriteBuffer(available);
+		const size_t count = std::min(available, size);
+		memcpy(buffer, data, count);
+		commitWrite(count);
+		data += count;
+		size -= count;
+	}
+}
+
+OSCStreamDeframer::Result OSCStreamDeframer::nextPacket(const char*& packet, size_t& size)
+{
+	if (m_frameMode == OSCStream::FRAME_MODE_1_0) {
+		return nextPacketLengthFramed(packet, size);
+	} else {
+		return nextSlipFramed(packet, size);
+	}
+}
+
+OSCStreamDeframer::Result OSCStreamDeframer::nextPacketLengthFramed(const char*& packet, size_t& size)
+{
+	// the first 4 bytes are the length of the OSC packet following as an int32:
+	int32_t packetLength = 0;
+	if (bufferedSize() < sizeof(packetLength)) return NO_PACKET;
+	char header[sizeof(packetLength)];
+	for (size_t i=0; i<sizeof(packetLength); ++i) {
+		header[i] = at(m_readPosition + i);
+	}
+	memcpy(&packetLength, header, sizeof(packetLength));
+	OSCArgument::Swap32(&packetLength);
+
+	// check if the length is in the range of a valid packet:
+	if (packetLength <= 0 || packetLength > OSCStream::MAX_FRAME_SIZE) {
+		// the stream can't be synchronized again, discard everything:
+		clear();
+		return INVALID_DATA;
+	}
+
+	// check if the packet is completely received:
+	if (bufferedSize() - sizeof(packetLength) < size_t(packetLength)) {
+		return NO_PACKET;
+	}
+
+	size = size_t(packetLength);
+	packet = getPacket(m_readPosition + sizeof(packetLength), size);
+	m_readPosition += sizeof(packetLength) + size;
+	return PACKET;
+}
+
+OSCStreamDeframer::Result OSCStreamDeframer::nextSlipFramed(const char*& packet, size_t& size)
+{
+	// A SLIP END character ends a packet, empty packets between two END characters are skipped.
+	while (m_scanPosition != m_writePosition) {
+		// search the contiguous part of the buffer:
+		const size_t scanIndex = m_scanPosition & m_mask;
+		const size_t length = std::min(m_writePosition - m_scanPosition, m_buffer.size() - scanIndex);
+		const char* begin = m_buffer.data() + scanIndex;
+		const char* end = static_cast<const char*>(memchr(begin, SLIP_CHAR(SLIP_END), length));
+		const size_t scanned = end ? size_t(end - begin) : length;
+		if (!m_packetHasEscapes && memchr(begin, SLIP_CHAR(SLIP_ESC), scanned)) {
+			m_packetHasEscapes = true;
+		}
+		m_scanPosition += scanned;
+
+		if (m_discarding) {
+			// skip the rest of a too long packet:
+			m_readPosition = m_scanPosition;
+		}
+
+		if (!end) {
+			if (m_scanPosition - m_readPosition > MAX_SLIP_ENCODED_SIZE) {
+				// too long without an END character, discard until the next one:
+				m_discarding = true;
+				m_readPosition = m_scanPosition;
+				m_packetHasEscapes = false;
+				return INVALID_DATA;
+			}
+			continue;
+		}
+
+		// END character found:
+		const size_t packetStart = m_readPosition;
+		size_t encodedSize = m_scanPosition - m_readPosition;
+		const bool hasEscapes = m_packetHasEscapes;
+		++m_scanPosition;
+		m_readPosition = m_scanPosition;
+		m_packetHasEscapes = false;
+
+		if (m_discarding) {
+			m_discarding = false;
+			continue;
+		}
+		if (encodedSize == 0) continue;
+
+		if (hasEscapes) {
+			packet = getSlipDecodedPacket(packetStart, encodedSize);
+		} else {
+			packet = getPacket(packetStart, encodedSize);
+		}
+		size = encodedSize;
+		return PACKET;
+	}
+	return NO_PACKET;
+}
+
+const char* OSCStreamDeframer::getPacket(size_t position, size_t size)
+{
+	const size_t index = position & m_mask;
+	if (index + size <= m_buffer.size()) {
+		// contiguous, no copy necessary:
+		return m_buffer.data() + index;
+	}
+	// the packet wraps around the end of the buffer:
+	if (m_packetBuffer.size() < size) m_packetBuffer.resize(size);
+	const size_t firstPart = m_buffer.size() - index;
+	memcpy(m_packetBuffer.data(), m_buffer.data() + index, firstPart);
+	memcpy(m_packetBuffer.data() + firstPart, m_buffer.data(), size - firstPart);
+	return m_packetBuffer.data();
+}
+
+const char* OSCStreamDeframer::getSlipDecodedPacket(size_t position, size_t& size)
+{
+	if (m_packetBuffer.size() < size) m_packetBuffer.resize(size);
+	size_t decodedSize = 0;
+	for (size_t i=0; i<size; ++i) {
+		char c = at(position + i);
+		if (c == SLIP_CHAR(SLIP_ESC) && i + 1 < size) {
+			++i;
+			c = at(position + i);
+			if (c == SLIP_CHAR(SLIP_ESC_END)) {
+				c = SLIP_CHAR(SLIP_END);
+			} else if (c == SLIP_CHAR(SLIP_ESC_ESC)) {
+				c = SLIP_CHAR(SLIP_ESC);
+			}
+		}
+		m_packetBuffer[decodedSize++] = c;
+	}
+	size = decodedSize;
+	return m_packetBuffer.data();
+}
+
+void OSCStreamDeframer::grow(size_t minimumCapacity)
+{
+	size_t capacity = m_buffer.size();
+	while (capacity < minimumCapacity) capacity *= 2;
+	if (capacity == m_buffer.size()) return;
+
+	// copy the buffered bytes to the beginning of the new buffer:
+	std::vector<char> buffer(capacity);
+	const size_t count = bufferedSize();
+	for (size_t i=0; i<count; ++i) {
+		buffer[i] = at(m_readPosition + i);
+	}
+	m_scanPosition -= m_readPosition;
+	m_readPosition = 0;
+	m_writePosition = count;
+	m_buffer.swap(buffer);
+	m_mask = capacity - 1;
+}
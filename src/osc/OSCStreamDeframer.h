@@ -0,0 +1,146 @@
+// Copyright (c) 2016 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef OSCSTREAMDEFRAMER_H
+#define OSCSTREAMDEFRAMER_H
+
+#include "OSCParser.h"
+
+#include <vector>
+#include <cstddef>
+
+
+/**
+ * @brief The OSCStreamDeframer class splits a TCP stream into OSC packets.
+ *
+ * It supports OSC 1.0 (packet-length framing) and OSC 1.1 (SLIP framing).
+ * The stream data is stored in a ring buffer. Bytes are never moved to the front and
+ * each byte is only scanned once, so the time is linear in the size of the stream,
+ * even if a large burst arrives in many small segments.
+ *
+ * Packets can be up to OSCStream::MAX_FRAME_SIZE bytes long. Longer ones are discarded
+ * and the stream is synchronized again.
+ */
+class OSCStreamDeframer
+{
+
+public:
+	/**
+	 * @brief The Result enum is returned by nextPacket()
+	 */
+	enum Result {
+		NO_PACKET,		// no complete packet yet
+		PACKET,			// a packet is returned
+		INVALID_DATA	// invalid data has been discarded, call nextPacket() again
+	};
+
+	/**
+	 * @brief OSCStreamDeframer creates an empty deframer
+	 * @param frameMode OSC 1.0 or 1.1 framing
+	 */
+	explicit OSCStreamDeframer(OSCStream::EnumFrameMode frameMode = OSCStream::FRAME_MODE_1_0);
+
+	/**
+	 * @brief setFrameMode sets the framing and discards all buffered data
+	 * @param frameMode OSC 1.0 or 1.1 framing
+	 */
+	void setFrameMode(OSCStream::EnumFrameMode frameMode);
+
+	/**
+	 * @brief clear discards all buffered data
+	 */
+	void clear();
+
+	/**
+	 * @brief getWriteBuffer returns free space at the end of the stream to write to directly,
+	 * the buffer grows if it is full
+	 * @param available is set to the number of bytes that can be written
+	 * @return pointer to the free space
+	 */
+	char* getWriteBuffer(size_t& available);
+
+	/**
+	 * @brief commitWrite appends the bytes written to the buffer returned by getWriteBuffer()
+	 * @param size number of bytes written
+	 */
+	void commitWrite(size_t size);
+
+	/**
+	 * @brief add appends a copy of the data to the stream
+	 * @param data pointer to the stream data
+	 * @param size size of the data in bytes
+	 */
+	void add(const char* data, size_t size);
+
+	/**
+	 * @brief nextPacket returns the next complete packet (without frame).
+	 * The data is only valid until the next call of a non-const method.
+	 * @param packet is set to the packet data
+	 * @param size is set to the size of the packet
+	 * @return PACKET if a packet is returned
+	 */
+	Result nextPacket(const char*& packet, size_t& size);
+
+	/**
+	 * @brief bufferedSize returns the number of bytes that are not yet returned as a packet
+	 * @return number of bytes
+	 */
+	size_t bufferedSize() const { return m_writePosition - m_readPosition; }
+
+private:
+	Result nextPacketLengthFramed(const char*& packet, size_t& size);
+	Result nextSlipFramed(const char*& packet, size_t& size);
+
+	/**
+	 * @brief getPacket returns size bytes from position without escaping them,
+	 * as a view into the ring buffer if possible
+	 */
+	const char* getPacket(size_t position, size_t size);
+
+	/**
+	 * @brief getSlipDecodedPacket returns size bytes from position with SLIP escapes replaced
+	 */
+	const char* getSlipDecodedPacket(size_t position, size_t& size);
+
+	char at(size_t position) const { return m_buffer[position & m_mask]; }
+
+	void grow(size_t minimumCapacity);
+
+	OSCStream::EnumFrameMode m_frameMode;
+
+	// The positions increase continuously, the index in the buffer is (position & m_mask).
+	// The buffer size is always a power of two.
+	std::vector<char>	m_buffer;
+	size_t				m_mask;
+	size_t				m_readPosition;
+	size_t				m_writePosition;
+
+	// SLIP: position up to which the stream has been searched for an END character
+	size_t				m_scanPosition;
+	// SLIP: true if the current packet contains escaped characters
+	bool				m_packetHasEscapes;
+	// SLIP: true while the rest of a too long packet is skipped
+	bool				m_discarding;
+
+	// used for packets that wrap around the end of the ring buffer or need to be unescaped
+	std::vector<char>	m_packetBuffer;
+};
+
+#endif // OSCSTREAMDEFRAMER_H
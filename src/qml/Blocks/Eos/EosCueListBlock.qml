@@ -120,7 +120,9 @@ BlockBase {
 
             StretchText {
                 anchors.fill: parent
-                text: "Cue List is empty, doesn't exist or is still loading."
+                text: controller.cueListManager().syncing
+                      ? "Loading Cue Lists... " + Math.round(controller.cueListManager().syncProgress * 100) + "%"
+                      : "Cue List is empty, doesn't exist or is still loading."
                 hAlign: Text.AlignHCenter
                 visible: cueListView.count === 0
             }
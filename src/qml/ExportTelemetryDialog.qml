@@ -0,0 +1,24 @@
+import QtQuick 2.5
+import QtQuick.Dialogs 1.2
+
+FileDialog {
+    id: exportDialog
+    title: "Export Connection Telemetry"
+    folder: shortcuts.home
+    selectMultiple: false
+    selectExisting: false
+    nameFilters: ["CSV Files (*.csv)"]
+
+    property QtObject telemetry
+
+    onAccepted: {
+        if (fileUrl && telemetry) {
+            telemetry.dumpToFile(fileUrl.toString())
+        }
+    }
+    Component.onCompleted: {
+        // don't set visible to true before component is complete
+        // because otherwise the dialog will not be configured correctly
+        visible = true
+    }
+}
@@ -11,6 +11,74 @@ StretchColumn {
     defaultSize: 30*dp
     height: implicitHeight
 
+    BlockRow {
+        StretchText {
+            text: "Realtime Engine:"
+        }
+        CheckBox {
+            width: 30*dp
+            active: controller.engine().realtimeMode
+            onActiveChanged: {
+                if (active !== controller.engine().realtimeMode) {
+                    controller.engine().realtimeMode = active
+                }
+            }
+        }
+    }
+    BlockRow {
+        visible: controller.engine().realtimeMode
+        StretchText {
+            text: "Late / Skipped Frames:"
+            color: "#aaa"
+        }
+        StretchText {
+            hAlign: Text.AlignRight
+            text: controller.engine().lateFrameCount.toFixed(0) + " / "
+                  + controller.engine().skippedBlockFrameCount.toFixed(0)
+        }
+    }
+    BlockRow {
+        visible: controller.engine().realtimeMode
+        StretchText {
+            text: "Last Frame Lateness:"
+            color: "#aaa"
+        }
+        StretchText {
+            hAlign: Text.AlignRight
+            text: (controller.engine().lastLateness * 1000).toFixed(2) + " ms"
+        }
+    }
+    BlockRow {
+        StretchText {
+            text: "Engine FPS:"
+        }
+        NumericInput {
+            implicitWidth: 0
+            width: 40*dp
+            value: controller.engine().fps
+            minimumValue: 30
+            maximumValue: 240
+            onValueChanged: {
+                if (value !== controller.engine().fps) {
+                    controller.engine().fps = value
+                }
+            }
+        }
+    }
+    BlockRow {
+        StretchText {
+            text: "Evaluate Nodes per Frame:"
+        }
+        CheckBox {
+            width: 30*dp
+            active: controller.blockManager().deferredEvaluation
+            onActiveChanged: {
+                if (active !== controller.blockManager().deferredEvaluation) {
+                    controller.blockManager().deferredEvaluation = active
+                }
+            }
+        }
+    }
     BlockRow {
         StretchText {
             text: "Send sACN:"
@@ -14,4 +14,8 @@ StretchColumn {
     OscConnectionArea {
         oscManager: controller.lightingConsole()
     }
+
+    OscTelemetryArea {
+        oscManager: controller.lightingConsole()
+    }
 }  // end Eos Connection Column
@@ -16,6 +16,10 @@ StretchColumn {
         showSpecificStatus: false
     }
 
+    OscTelemetryArea {
+        oscManager: controller.customOsc()
+    }
+
 //    BlockRow {
 //        visible: !controller.sendCustomOscToEos
 //        Text {
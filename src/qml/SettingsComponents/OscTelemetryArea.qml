@@ -0,0 +1,91 @@
+import QtQuick 2.5
+import CustomElements 1.0
+
+import "../CustomControls"
+import "../CustomBasics"
+
+StretchColumn {
+    id: root
+    defaultSize: 30*dp
+    height: implicitHeight
+
+    property QtObject oscManager
+    property QtObject telemetry: oscManager.telemetry()
+
+    function formatRtt(value) {
+        return value < 0 ? "-" : value.toFixed(value < 10 ? 2 : 0)
+    }
+
+    BlockRow {
+        StretchText {
+            text: "RTT p50/p95/p99 (1 min):"
+            color: "#aaa"
+        }
+        StretchText {
+            hAlign: Text.AlignRight
+            text: formatRtt(telemetry.rttP50) + " / " + formatRtt(telemetry.rttP95)
+                  + " / " + formatRtt(telemetry.rttP99) + " ms"
+        }
+    }
+    BlockRow {
+        StretchText {
+            text: "In:"
+            color: "#aaa"
+        }
+        StretchText {
+            hAlign: Text.AlignRight
+            text: telemetry.messagesInPerSecond.toFixed(0) + " msg/s | "
+                  + (telemetry.bytesInPerSecond / 1000).toFixed(1) + " kB/s"
+        }
+    }
+    BlockRow {
+        StretchText {
+            text: "Out:"
+            color: "#aaa"
+        }
+        StretchText {
+            hAlign: Text.AlignRight
+            text: telemetry.messagesOutPerSecond.toFixed(0) + " msg/s | "
+                  + (telemetry.bytesOutPerSecond / 1000).toFixed(1) + " kB/s"
+        }
+    }
+    BlockRow {
+        StretchText {
+            text: "Queue:"
+            color: "#aaa"
+        }
+        StretchText {
+            hAlign: Text.AlignRight
+            text: telemetry.queueDepth + " msg | " + telemetry.pendingBytes + " B pending"
+        }
+    }
+    BlockRow {
+        StretchText {
+            text: "Reconnects / Errors / Invalid:"
+            color: "#aaa"
+        }
+        StretchText {
+            hAlign: Text.AlignRight
+            text: telemetry.reconnects + " / " + telemetry.connectionErrors + " / " + telemetry.parseErrors
+            color: telemetry.parseErrors > 0 ? "orange" : "#fff"
+        }
+    }
+    BlockRow {
+        ButtonBottomLine {
+            text: "Reset"
+            onClick: telemetry.clear()
+        }
+        ButtonBottomLine {
+            text: "Export CSV"
+            onClick: {
+                exportDialogLoader.source = ""
+                exportDialogLoader.source = "qrc:/qml/ExportTelemetryDialog.qml"
+            }
+
+            Loader {
+                id: exportDialogLoader
+                onLoaded: item.telemetry = root.telemetry
+            }
+        }
+    }
+}
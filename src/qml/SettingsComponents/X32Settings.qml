@@ -15,6 +15,10 @@ StretchColumn {
         oscManager: controller.audioConsole()
     }
 
+    OscTelemetryArea {
+        oscManager: controller.audioConsole()
+    }
+
 //    BlockRow {
 //        Text {
 //            text: "IP Address:"
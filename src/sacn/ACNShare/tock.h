@@ -99,6 +99,7 @@ public:
 	void Reset();	//Resets the timer, using the current timeout interval
 	bool Expired();  //Returns true if the timer has expired.
 					 //Call Reset() to use this timer again for a new interval.
+	int4 GetRemaining();  //Returns the ms until the timer expires, 0 if it has expired
 protected:
 	int4 interval;
 	tock tockout;
@@ -115,6 +116,7 @@ inline void ttimer::SetInterval(int4 ms) {interval = ms; Reset();}
 inline int4 ttimer::GetInterval() {return interval;}
 inline void ttimer::Reset() {tockout.Setms(Tock_GetTock().Getms() + interval);}
 inline bool ttimer::Expired() {return Tock_GetTock() > tockout;}
+inline int4 ttimer::GetRemaining() {int4 r = int4(tockout - Tock_GetTock()); return (r > 0) ? r : 0;}
 
 /*tock implementation*/
 inline tock::tock():v(0) {}
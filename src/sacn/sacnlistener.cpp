@@ -14,6 +14,9 @@
 // limitations under the License.
 
 #include "sacnlistener.h"
+#include "sacnreceiver.h"
+#include "sacnmerge.h"
+#include "sacnsubscription.h"
 
 #include "streamcommon.h"
 #include "ACNShare/deftypes.h"
@@ -40,18 +43,41 @@ sACNListener::sACNListener(int universe, QObject *parent) : QObject(parent),
     m_universe(universe),
     m_ssHLL(1000),
     m_isSampling(true),
-    m_mergesPerSecond(0)
+    m_initalSampleTimer(nullptr),
+    m_expirationTimer(nullptr),
+    m_mergeScheduled(false),
+    m_deleted(false),
+    m_mergesPerSecond(0),
+    m_diagnosticsDirty(false),
+    m_snapshotSequence(0),
+    m_snapshotMergeNumber(0)
 {
     m_merged_levels.reserve(512);
     for(int i=0; i<512; i++)
         m_merged_levels << sACNMergedAddress();
+
+    for(auto &word : m_snapshotLevelWords)
+        word.store(0, std::memory_order_relaxed);
+    for(int i=0; i<512/32; i++)
+    {
+        m_snapshotValidBits[i].store(0, std::memory_order_relaxed);
+        m_snapshotChangedBits[i].store(0, std::memory_order_relaxed);
+    }
+    memset(m_mergedPriorities, 0, sizeof(m_mergedPriorities));
+    memset(m_publishedLevels, 0, sizeof(m_publishedLevels));
+    memset(m_publishedValidBits, 0, sizeof(m_publishedValidBits));
+    memset(m_publishedChangedBits, 0, sizeof(m_publishedChangedBits));
 }
 
 sACNListener::~sACNListener()
 {
-    m_initalSampleTimer->deleteLater();
-    m_mergeTimer->deleteLater();
-    qDeleteAll(m_sockets);
+    // Normally already done by sACNManager::listenerDelete(), but startReception() could have
+    // registered this listener again in the meantime
+    sACNManager::getInstance()->getReceiver()->removeListener(m_universe, this);
+    if(m_initalSampleTimer)
+        m_initalSampleTimer->deleteLater();
+    if(m_expirationTimer)
+        m_expirationTimer->deleteLater();
     qDebug() << "sACNListener" << QThread::currentThreadId() << ": stopping";
 }
 
@@ -62,24 +88,6 @@ void sACNListener::startReception()
     // Clear the levels array
     memset(&m_last_levels, -1, 512);
 
-    // Listen multicast
-    m_sockets.push_back(new sACNRxSocket());
-    if (m_sockets.back()->bindMulticast(m_universe)) {
-        connect(m_sockets.back(), SIGNAL(readyRead()), this, SLOT(readPendingDatagrams()), Qt::DirectConnection);
-    } else {
-       // Failed to bind,
-       m_sockets.pop_back();
-    }
-
-    // Listen unicast
-    m_sockets.push_back(new sACNRxSocket());
-    if (m_sockets.back()->bindUnicast()) {
-        connect(m_sockets.back(), SIGNAL(readyRead()), this, SLOT(readPendingDatagrams()), Qt::DirectConnection);
-    } else {
-       // Failed to bind
-       m_sockets.pop_back();
-    }
-
     // Start intial sampling
     m_initalSampleTimer = new QTimer(this);
     m_initalSampleTimer->setSingleShot(true);
@@ -87,14 +95,60 @@ void sACNListener::startReception()
     connect(m_initalSampleTimer, SIGNAL(timeout()), this, SLOT(sampleExpiration()), Qt::DirectConnection);
     m_initalSampleTimer->start();
 
-    // Merge is performed whenever the thread has time
+    // Merge is performed when datagrams arrived (see scheduleMerge()),
+    // sources are checked when the nearest of their timeouts is reached
     m_elapsedTime.start();
     m_mergesPerSecondTimer.start();
-    m_mergeTimer = new QTimer(this);
-    m_mergeTimer->setInterval(1);
-    connect(m_mergeTimer, SIGNAL(timeout()), this, SLOT(performMerge()), Qt::DirectConnection);
-    connect(m_mergeTimer, SIGNAL(timeout()), this, SLOT(checkSourceExpiration()), Qt::DirectConnection);
-    m_mergeTimer->start();
+    m_expirationTimer = new QTimer(this);
+    m_expirationTimer->setSingleShot(true);
+    m_expirationTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_expirationTimer, SIGNAL(timeout()), this, SLOT(checkSourceExpiration()), Qt::DirectConnection);
+
+    // Datagrams are passed to this listener from now on,
+    // unless it was released before it started
+    if(!m_deleted.load())
+        sACNManager::getInstance()->getReceiver()->addListener(m_universe, this);
+}
+
+void sACNListener::scheduleMerge()
+{
+    // Called in the thread of the shared sACNReceiver (this listener lives in it, too),
+    // while it processes the datagrams of one readyRead or from the expiration timer.
+    // The merge is queued behind the pending datagrams, the flag makes sure it is queued
+    // only once. No other thread accesses the flag, so it needs no lock.
+    if(!m_mergeScheduled)
+    {
+        m_mergeScheduled = true;
+        QMetaObject::invokeMethod(this, "performMerge", Qt::QueuedConnection);
+    }
+}
+
+void sACNListener::updateExpirationTimer()
+{
+    // Find the nearest point in time at which checkSourceExpiration() could change something
+    int nearest = -1;
+    for(std::vector<sACNSource *>::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
+    {
+        sACNSource *ps = *it;
+        if(!ps->src_valid)
+            continue;
+        // Lost when both timers expired
+        int remaining = qMax(ps->active.GetRemaining(), ps->priority_wait.GetRemaining());
+        // Stops per-channel priority when the priority timer expired
+        if(ps->doing_per_channel)
+            remaining = qMin(remaining, ps->priority_wait.GetRemaining());
+        if(nearest < 0 || remaining < nearest)
+            nearest = remaining;
+    }
+
+    if(nearest < 0)
+    {
+        // No valid sources, nothing to wait for
+        m_expirationTimer->stop();
+        return;
+    }
+    // ttimer::Expired() is true only after the timeout, so wait one more ms
+    m_expirationTimer->start(nearest + 1);
 }
 
 
@@ -129,39 +183,13 @@ void sACNListener::checkSourceExpiration()
             }
         }
     }
-}
 
-void sACNListener::readPendingDatagrams()
-{
-    #if (QT_VERSION == QT_VERSION_CHECK(5, 9, 3))
-        #error "QT5.9.3 QUdpSocket::readDatagram Returns incorrect infomation: https://bugreports.qt.io/browse/QTBUG-64784"
-    #endif
-    #if (QT_VERSION == QT_VERSION_CHECK(5, 10, 0))
-        #error "QT5.10.0 QUdpSocket::readDatagram Returns incorrect infomation: https://bugreports.qt.io/browse/QTBUG-65099"
-    #endif
-
-    // Check all sockets
-    foreach (sACNRxSocket* m_socket, m_sockets)
-    {
-        while(m_socket->hasPendingDatagrams())
-        {
-            QByteArray data;
-            data.resize(m_socket->pendingDatagramSize());
-            QHostAddress sender;
-            quint16 senderPort;
-
-            m_socket->readDatagram(data.data(), data.size(),
-                                    &sender, &senderPort);
-
-            processDatagram(
-                        data,
-                        m_socket->localAddress(),
-                        sender);
-        }
-    }
+    if(m_mergeAll)
+        scheduleMerge();
+    updateExpirationTimer();
 }
 
-void sACNListener::processDatagram(QByteArray data, QHostAddress receiver, QHostAddress sender)
+void sACNListener::processDatagram(const QByteArray &data, const QHostAddress &receiver, const QHostAddress &sender)
 {
     // Process packet
     CID source_cid;
@@ -179,7 +207,8 @@ void sACNListener::processDatagram(QByteArray data, QHostAddress receiver, QHost
     uint2 reserved = 0;
     uint1 options = 0;
     bool preview = false;
-    uint1 *pbuf = reinterpret_cast<uint1*>(data.data());
+    // The data is not modified, constData() avoids a copy of the receive buffer
+    uint1 *pbuf = const_cast<uint1*>(reinterpret_cast<const uint1*>(data.constData()));
 
     if(!ValidateStreamHeader(pbuf, data.length(), source_cid, source_name, priority,
             start_code, reserved, sequence, options, universe, slot_count, pdata))
@@ -192,22 +221,11 @@ void sACNListener::processDatagram(QByteArray data, QHostAddress receiver, QHost
     // Unpacks a uint4 from a known big endian buffer
     int root_vect = UpackB4((uint1*)pbuf + ROOT_VECTOR_ADDR);
 
-    // Packet for the wrong universe on this socket?
+    // Packet for the wrong universe? (the sACNReceiver demultiplexes by universe already)
     if(m_universe != universe)
     {
-        // Was it unicast? Send to correct listner (if listening)
-        if (receiver.isMulticast())
-        {
-            // Log and discard
-            qDebug() << "sACNListener" << QThread::currentThreadId() << ": Wrong Universe and is multicast";
-            return;
-        } else {
-            // Unicast, send to releivent listener!
-            const QHash<int, QWeakPointer<sACNListener> > listenerList = sACNManager::getInstance()->getListenerList();
-            if (listenerList.contains(universe))
-                listenerList[universe].data()->processDatagram(data, receiver, sender);
-            return;
-        }
+        qDebug() << "sACNListener" << QThread::currentThreadId() << ": Wrong Universe";
+        return;
     }
 
     // Listen to preview?
@@ -334,6 +352,8 @@ void sACNListener::processDatagram(QByteArray data, QHostAddress receiver, QHost
     if(!validpacket)
     {
         qDebug() << "sACNListener" << QThread::currentThreadId() << ": Source coming up, not processing packet";
+        // The source timers changed, the merge updates the expiration timer
+        scheduleMerge();
         return;
     }
 
@@ -492,17 +512,18 @@ void sACNListener::processDatagram(QByteArray data, QHostAddress receiver, QHost
             ps->source_params_change = false;
         }
     }
+
+    // Merge once after all currently pending datagrams are processed
+    if(ps->source_levels_change || m_mergeAll)
+        scheduleMerge();
 }
 
 void sACNListener::performMerge()
 {
-    //array of addresses to merge. to prevent duplicates and because you can have
-    //an odd collection of addresses, addresses[n] would be 'n' for the value in question
-    // and -1 if not required
-    int addresses_to_merge[512];
-    int number_of_addresses_to_merge = 0;
+    m_mergeScheduled = false;
 
-    memset(addresses_to_merge, -1, sizeof(int) * 512);
+    // Source timers may have changed with the processed datagrams
+    updateExpirationTimer();
 
     {
         QMutexLocker locker(&m_monitoredChannelsMutex);
@@ -510,7 +531,7 @@ void sACNListener::performMerge()
         {
             QPointF data;
             data.setX(m_elapsedTime.nsecsElapsed()/1000000.0);
-            data.setY(mergedLevels().at(chan).level);
+            data.setY(m_merged_levels.at(chan).level);
             emit dataReady(chan, data);
         }
     }
@@ -524,145 +545,261 @@ void sACNListener::performMerge()
 
     m_mergeCounter++;
 
+    // Step one : find out if anything changed
+    bool anythingChanged = m_mergeAll;
+    m_mergeAll = false;
+    for(std::vector<sACNSource *>::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
+    {
+        sACNSource *ps = *it;
+        if(!ps->src_valid)
+            continue; // Inactive source, ignore it
+        if(!ps->source_levels_change)
+            continue; // We don't need to consider this one, no change
+        anythingChanged = true;
+        // Clear the flags
+        memset(ps->dirty_array, 0 , 512);
+        ps->source_levels_change = false;
+    }
+
+    if(!anythingChanged) return; // Nothing to do
 
+    // Step two : merge all sources over whole arrays,
+    // highest priority wins, HTP between sources of the same priority
+    uint1 mergedPriorities[512];
+    uint1 mergedLevels[512];
+    uint1 effectivePriorities[512];
+    memset(mergedPriorities, 0, sizeof(mergedPriorities));
+    memset(mergedLevels, 0, sizeof(mergedLevels));
 
-    // Step one : find any addresses which have changed
-    if(m_mergeAll) // Act like all addresses changed
+    for(std::vector<sACNSource *>::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
     {
-        number_of_addresses_to_merge = 512;
-        for(int i=0; i<512; i++)
+        sACNSource *ps = *it;
+        if(!ps->src_valid)
+            continue;
+
+        if(!ps->active.Expired() && !ps->doing_per_channel)
         {
-            addresses_to_merge[i] = i;
+            // Set the priority array for sources which are not doing per-channel
+            memset(ps->priority_array, ps->priority, sizeof(ps->priority_array));
         }
 
-        m_mergeAll = false;
+        sACNMergeEffectivePriorities(ps->priority_array, ps->doing_per_channel, effectivePriorities, 512);
+        sACNMergeSource(ps->level_array, effectivePriorities, mergedPriorities, mergedLevels, 512);
     }
-    else
+
+    // Step three : store the result, addresses without any source are invalid (-1)
+    for(int i=0; i<512; i++)
     {
-        for(std::vector<sACNSource *>::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
-        {
-            sACNSource *ps = *it;
-            if(!ps->src_valid)
-                continue; // Inactive source, ignore it
-            if(!ps->source_levels_change)
-                continue; // We don't need to consider this one, no change
-            for(int i=0; i<512; i++)
-            {
-                if(ps->dirty_array[i])
-                {
-                    addresses_to_merge[i] = i;
-                    number_of_addresses_to_merge++;
-                }
-            }
-            // Clear the flags
-            memset(ps->dirty_array, 0 , 512);
-            ps->source_levels_change = false;
-        }
+        const int level = mergedPriorities[i] ? mergedLevels[i] : -1;
+        sACNMergedAddress &merged = m_merged_levels[i];
+        merged.changedSinceLastMerge = (merged.level != level);
+        merged.level = level;
     }
+    memcpy(m_mergedPriorities, mergedPriorities, sizeof(m_mergedPriorities));
+
+    // Winning and other sources are only needed by mergedLevels()
+    m_diagnosticsDirty = true;
 
-    if(number_of_addresses_to_merge == 0) return; // Nothing to do
+    // Make the result available to other threads
+    publishLevels();
+    notifySubscriptions();
 
-    // Clear out the sources list for all the affected channels, we'll be refreshing it
+    // Tell people..
+    emit levelsChanged();
+}
 
-    int skipCounter = 0;
-    for(int i=0; i < 512 && i<(number_of_addresses_to_merge + skipCounter); i++)
+sACNMergedSourceList sACNListener::mergedLevels()
+{
+    if(m_diagnosticsDirty)
+        updateMergeDiagnostics();
+    return m_merged_levels;
+}
+
+void sACNListener::updateMergeDiagnostics()
+{
+    m_diagnosticsDirty = false;
+    for(int i=0; i<512; i++)
+    {
+        m_merged_levels[i].winningSource = nullptr;
+        m_merged_levels[i].otherSources.clear();
+    }
+
+    uint1 effectivePriorities[512];
+    for(std::vector<sACNSource *>::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
     {
-        m_merged_levels[i].changedSinceLastMerge = false;
-        if(addresses_to_merge[i] == -1) {
-            ++skipCounter;
+        sACNSource *ps = *it;
+        if(!ps->src_valid)
             continue;
+        const bool active = !ps->active.Expired();
+        sACNMergeEffectivePriorities(ps->priority_array, ps->doing_per_channel, effectivePriorities, 512);
+        for(int i=0; i<512; i++)
+        {
+            sACNMergedAddress &merged = m_merged_levels[i];
+            // The first source with the winning priority and level is the winner
+            if(!merged.winningSource && m_mergedPriorities[i]
+                    && effectivePriorities[i] == m_mergedPriorities[i]
+                    && ps->level_array[i] == merged.level)
+            {
+                merged.winningSource = ps;
+            }
+            else if(active)
+            {
+                merged.otherSources << ps;
+            }
         }
-        sACNMergedAddress *pAddr = &m_merged_levels[addresses_to_merge[i]];
-        pAddr->otherSources.clear();
     }
+}
 
-    // Find the highest priority source for each address we need to work on
-
-    int levels[512];
-    memset(&levels, -1, sizeof(levels));
+void sACNListener::publishLevels()
+{
+    // Build the new state and the changed bitmap in the listener thread first
+    uint8_t levels[512];
+    uint32_t validBits[512/32];
+    uint32_t changedBits[512/32];
+    memset(validBits, 0, sizeof(validBits));
+    memset(changedBits, 0, sizeof(changedBits));
+    for(int i=0; i<512; i++)
+    {
+        const int level = m_merged_levels[i].level;
+        levels[i] = (level < 0) ? 0 : uint8_t(level);
+        if(level >= 0)
+            validBits[i/32] |= (1u << (i%32));
+        if(levels[i] != m_publishedLevels[i])
+            changedBits[i/32] |= (1u << (i%32));
+    }
+    for(int i=0; i<512/32; i++)
+        changedBits[i] |= validBits[i] ^ m_publishedValidBits[i];
+    memcpy(m_publishedLevels, levels, sizeof(levels));
+    memcpy(m_publishedValidBits, validBits, sizeof(validBits));
+    memcpy(m_publishedChangedBits, changedBits, sizeof(changedBits));
+
+    // Seqlock write: odd sequence while writing, readers retry if they see it or a change
+    const quint32 sequence = m_snapshotSequence.load(std::memory_order_relaxed);
+    m_snapshotSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for(int i=0; i<512/4; i++)
+    {
+        uint32_t word;
+        memcpy(&word, levels + i*4, sizeof(word));
+        m_snapshotLevelWords[i].store(word, std::memory_order_relaxed);
+    }
+    for(int i=0; i<512/32; i++)
+    {
+        m_snapshotValidBits[i].store(validBits[i], std::memory_order_relaxed);
+        m_snapshotChangedBits[i].store(changedBits[i], std::memory_order_relaxed);
+    }
+    m_snapshotMergeNumber.store(m_snapshotMergeNumber.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 
-    int priorities[512];
-    memset(&priorities, -1, sizeof(priorities));
+    m_snapshotSequence.store(sequence + 2, std::memory_order_release);
+}
 
-    QMultiMap<int, sACNSource*> addressToSourceMap;
+void sACNListener::addSubscription(sACNRangeSubscription *subscription)
+{
+    Subscription entry;
+    entry.subscription = subscription;
+    entry.start = subscription->start();
+    entry.count = subscription->count();
+    QMutexLocker locker(&m_subscriptionsMutex);
+    m_subscriptions.append(entry);
+}
 
-	// Find the highest priority for the address
-    for(std::vector<sACNSource *>::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
+void sACNListener::removeSubscription(sACNRangeSubscription *subscription)
+{
+    QMutexLocker locker(&m_subscriptionsMutex);
+    for(int i=0; i<m_subscriptions.size(); i++)
     {
-        sACNSource *ps = *it;
- 
-        if(ps->src_valid && !ps->active.Expired() && !ps->doing_per_channel)
+        if(m_subscriptions[i].subscription == subscription)
         {
-            // Set the priority array for sources which are not doing per-channel
-            memset(ps->priority_array, ps->priority, sizeof(ps->priority_array));
+            m_subscriptions.remove(i);
+            return;
         }
+    }
+}
 
-        skipCounter = 0;
-        for(int i=0; i < 512 && i<(number_of_addresses_to_merge + skipCounter); i++)
+void sACNListener::notifySubscriptions()
+{
+    // The mutex also makes sure that a subscription isn't deleted while it's used here
+    QMutexLocker locker(&m_subscriptionsMutex);
+    foreach(const Subscription &entry, m_subscriptions)
+    {
+        bool changed = false;
+        const int end = entry.start + entry.count;
+        for(int i=entry.start; i<end && !changed; i++)
         {
-            if(addresses_to_merge[i] == -1) {
-               ++skipCounter;
+            const uint32_t word = m_publishedChangedBits[i/32];
+            if(!word)
+            {
+                // Nothing changed in this word, continue with the next one
+                i |= 31;
                 continue;
             }
-            sACNMergedAddress *pAddr = &m_merged_levels[addresses_to_merge[i]];
-            int address = addresses_to_merge[i];
-
-			if (
-					ps->src_valid // Valid Source
-					&& !(ps->priority_array[address] < priorities[address]) // Not lesser priority
-					&& ( (ps->priority_array[address] > 0) || (ps->priority_array[address] == 0 && !ps->doing_per_channel) ) // Priority > 0 if DD
-				)
-			{
-				if (ps->priority_array[address] > priorities[address])
-				{
-					// Source of higher priority
-					priorities[address] = ps->priority_array[address];
-					addressToSourceMap.remove(address);
-				}
-				addressToSourceMap.insert(address, ps);
-			}
-
-            if(ps->src_valid && !ps->active.Expired())
-                pAddr->otherSources << ps;
+            changed = (word & (1u << (i%32))) != 0;
         }
-    }
-
+        if(!changed)
+            continue;
 
+        // Queued, so that the subscription gets the levels in its own thread
+        QByteArray levels(reinterpret_cast<const char *>(m_publishedLevels) + entry.start, entry.count);
+        QMetaObject::invokeMethod(entry.subscription, "deliverLevels", Qt::QueuedConnection,
+                                  Q_ARG(QByteArray, levels));
+    }
+}
 
-    // Next, find highest level for the highest prioritized sources
-    skipCounter = 0;
-    for(int i=0; i < 512 && i<(number_of_addresses_to_merge + skipCounter); i++)
-    {
-        if(addresses_to_merge[i] == -1) {
-            ++skipCounter;
+void sACNListener::readLevelSnapshot(sACNLevelSnapshot &snapshot) const
+{
+    quint32 before, after;
+    do {
+        before = m_snapshotSequence.load(std::memory_order_acquire);
+        if(before & 1)
+        {
+            // The listener thread is publishing right now
+            QThread::yieldCurrentThread();
             continue;
         }
-        int address = addresses_to_merge[i];
-        QList<sACNSource*> sourceList = addressToSourceMap.values(address);
-
-        if(sourceList.count() == 0)
+        for(int i=0; i<512/4; i++)
         {
-            m_merged_levels[address].level = -1;
-            m_merged_levels[address].winningSource = nullptr;
-            m_merged_levels[address].otherSources.clear();
+            const uint32_t word = m_snapshotLevelWords[i].load(std::memory_order_relaxed);
+            memcpy(snapshot.levels + i*4, &word, sizeof(word));
         }
-        foreach(sACNSource *s, sourceList)
+        for(int i=0; i<512/32; i++)
         {
-            if(s->level_array[address] > levels[address])
-            {
-                levels[address] = s->level_array[address];
-                m_merged_levels[address].changedSinceLastMerge = (m_merged_levels[address].level != levels[address]);
-                m_merged_levels[address].level = levels[address];
-                m_merged_levels[address].winningSource = s;
-            }
+            snapshot.validBits[i] = m_snapshotValidBits[i].load(std::memory_order_relaxed);
+            snapshot.changedBits[i] = m_snapshotChangedBits[i].load(std::memory_order_relaxed);
         }
-        // Remove the winning source from the list of others
-        if(m_merged_levels[address].winningSource)
-            m_merged_levels[address].otherSources.remove(m_merged_levels[address].winningSource);
-    }
+        snapshot.mergeNumber = m_snapshotMergeNumber.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = m_snapshotSequence.load(std::memory_order_relaxed);
+    } while((before & 1) || before != after);
+}
 
+int sACNListener::readLevels(int firstAddress, int count, uint8_t *levels) const
+{
+    if(firstAddress < 0 || firstAddress >= 512 || count <= 0)
+        return 0;
+    count = qMin(count, 512 - firstAddress);
+    const int firstWord = firstAddress / 4;
+    const int lastWord = (firstAddress + count - 1) / 4;
+
+    uint8_t buffer[512];
+    quint32 before, after;
+    do {
+        before = m_snapshotSequence.load(std::memory_order_acquire);
+        if(before & 1)
+        {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        for(int i=firstWord; i<=lastWord; i++)
+        {
+            const uint32_t word = m_snapshotLevelWords[i].load(std::memory_order_relaxed);
+            memcpy(buffer + i*4, &word, sizeof(word));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = m_snapshotSequence.load(std::memory_order_relaxed);
+    } while((before & 1) || before != after);
 
-    // Tell people..
-    emit levelsChanged();
+    memcpy(levels, buffer + firstAddress, size_t(count));
+    return count;
 }
 
@@ -20,11 +20,16 @@
 #include <QThread>
 #include <vector>
 #include <list>
+#include <atomic>
+#include <cstdint>
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QPoint>
+#include <QVector>
 #include "streamingacn.h"
-#include "sacnsocket.h"
+
+// Forward Declarations
+class sACNRangeSubscription;
 
 /**
  * @brief The sACNMergedAddress struct contains the current level of a specific channel and
@@ -57,6 +62,35 @@ struct sACNMergedAddress
 
 typedef QList<sACNMergedAddress> sACNMergedSourceList;
 
+/**
+ * @brief The sACNLevelSnapshot struct is a flat copy of the merged levels of a universe
+ * as published after a merge, see sACNListener::readLevelSnapshot()
+ */
+struct sACNLevelSnapshot
+{
+    /**
+     * @brief levels DMX value of each address, 0 if no source is sending it
+     */
+    uint8_t levels[512];
+    /**
+     * @brief validBits bitmap of addresses that have a source
+     */
+    uint32_t validBits[512 / 32];
+    /**
+     * @brief changedBits bitmap of addresses that changed in the merge that published this snapshot
+     */
+    uint32_t changedBits[512 / 32];
+    /**
+     * @brief mergeNumber is incremented with each published merge, if a reader sees a gap
+     * of more than one it missed changes and should treat all addresses as changed
+     */
+    quint32 mergeNumber;
+
+    int level(int address) const { return levels[address]; }
+    bool isValid(int address) const { return validBits[address / 32] & (1u << (address % 32)); }
+    bool changed(int address) const { return changedBits[address / 32] & (1u << (address % 32)); }
+};
+
 /**
  * @brief The sACNListener class is used to listen to  a universe of sACN.
  * The class should not be instantiated directly; instead use sACNManager to get the
@@ -74,21 +108,57 @@ public:
      * @return the universe which this listener is listening for
      */
     int universe() {return m_universe;}
+    /**
+     * @brief markDeleted is called when the last shared pointer to this listener is released,
+     * the listener doesn't register itself at the receiver afterwards, can be called from any thread
+     */
+    void markDeleted() { m_deleted.store(true); }
     /**
      * @brief mergedLevels
      * @return an sACNMergerdSourceList, a list of merged address structures, allowing you to see
-     * the result of the merge algorithm together with all the sub-sources, by address
+     * the result of the merge algorithm together with all the sub-sources, by address.
+     * The winning and other sources are determined only when this is called, it has to be called
+     * in the thread of the listener. Use readLevelSnapshot() or readLevels() for the levels only.
+     */
+    sACNMergedSourceList mergedLevels();
+
+    /**
+     * @brief readLevelSnapshot copies the last published merged levels, can be called from any thread
+     * without locking (the listener thread is never blocked, the reader retries if a merge is published
+     * during the copy)
+     * @param snapshot is filled with the levels, validity and changed bitmaps
+     */
+    void readLevelSnapshot(sACNLevelSnapshot& snapshot) const;
+
+    /**
+     * @brief readLevels copies a range of the last published merged levels, can be called
+     * from any thread without locking, all values are from the same merge
+     * @param firstAddress 0-based index of the first address
+     * @param count number of addresses to read, is limited to the end of the universe
+     * @param levels destination for the levels, 0 if no source is sending an address
+     * @return the number of copied levels
      */
-    sACNMergedSourceList mergedLevels() { return m_merged_levels;}
+    int readLevels(int firstAddress, int count, uint8_t* levels) const;
+
+    /**
+     * @brief addSubscription registers a subscription, it gets the levels of its range
+     * after each merge that changed one of them, can be called from any thread
+     * (subscriptions are created with sACNManager::subscribe())
+     */
+    void addSubscription(sACNRangeSubscription* subscription);
+    /**
+     * @brief removeSubscription unregisters a subscription, can be called from any thread
+     */
+    void removeSubscription(sACNRangeSubscription* subscription);
 
     std::size_t sourceCount() { return m_sources.size();}
     sACNSource *source(std::size_t index) { return m_sources[index];}
 
     /**
      *  @brief processDatagram Process a suspected sACN datagram.
-     * This allows other listeners to pass on unicast datagrams for other universes
+     * Called by the sACNReceiver for datagrams of this universe, in the thread of this listener
      */
-    void processDatagram(QByteArray data, QHostAddress receiver, QHostAddress sender);
+    void processDatagram(const QByteArray &data, const QHostAddress &receiver, const QHostAddress &sender);
 
     // Diagnostic - the number of merge operations per second
 
@@ -110,12 +180,33 @@ signals:
     void levelsChanged();
     void dataReady(int address, QPointF data);
 private slots:
-    void readPendingDatagrams();
     void performMerge();
     void checkSourceExpiration();
     void sampleExpiration();
 private:
-    std::list<sACNRxSocket *> m_sockets;
+    /**
+     * @brief scheduleMerge queues a merge in the listener thread, multiple calls before
+     * it runs (i.e. all datagrams of one readyRead) result in a single merge
+     */
+    void scheduleMerge();
+    /**
+     * @brief updateExpirationTimer sets the expiration timer to the nearest source timeout
+     */
+    void updateExpirationTimer();
+
+    /**
+     * @brief publishLevels writes the merged levels to the snapshot buffer read by other threads
+     */
+    void publishLevels();
+    /**
+     * @brief updateMergeDiagnostics fills winningSource and otherSources of m_merged_levels
+     */
+    void updateMergeDiagnostics();
+    /**
+     * @brief notifySubscriptions sends the levels to subscriptions with a changed address
+     */
+    void notifySubscriptions();
+
     std::vector<sACNSource *> m_sources;
     int m_last_levels[512];
     sACNMergedSourceList m_merged_levels;
@@ -125,7 +216,10 @@ private:
     // Are we in the initial sampling state
     bool m_isSampling;
     QTimer *m_initalSampleTimer;
-    QTimer *m_mergeTimer;
+    QTimer *m_expirationTimer;
+    bool m_mergeScheduled;
+    // True if this listener is about to be deleted
+    std::atomic<bool> m_deleted;
     QElapsedTimer m_elapsedTime;
     int m_predictableTimerValue;
     QMutex m_monitoredChannelsMutex;
@@ -134,6 +228,32 @@ private:
     unsigned int m_mergesPerSecond;
     int m_mergeCounter;
     QElapsedTimer m_mergesPerSecondTimer;
+    // Effective priority of the merged level of each address (0 if no source, see sacnmerge.h)
+    uint1 m_mergedPriorities[512];
+    // True if winningSource and otherSources of m_merged_levels are outdated
+    bool m_diagnosticsDirty;
+
+    // Lock-free published levels (seqlock), 4 levels per word to avoid data races with readers.
+    // The sequence is odd while the listener thread writes.
+    std::atomic<quint32> m_snapshotSequence;
+    std::atomic<uint32_t> m_snapshotLevelWords[512 / 4];
+    std::atomic<uint32_t> m_snapshotValidBits[512 / 32];
+    std::atomic<uint32_t> m_snapshotChangedBits[512 / 32];
+    std::atomic<quint32> m_snapshotMergeNumber;
+    // Last published state, only used in the listener thread:
+    uint8_t m_publishedLevels[512];
+    uint32_t m_publishedValidBits[512 / 32];
+    uint32_t m_publishedChangedBits[512 / 32];
+
+    // Range subscriptions, added and removed from other threads
+    struct Subscription
+    {
+        sACNRangeSubscription* subscription;
+        int start;
+        int count;
+    };
+    QMutex m_subscriptionsMutex;
+    QVector<Subscription> m_subscriptions;
 };
 
 
@@ -0,0 +1,124 @@
+// Copyright 2016 Tom Barthel-Steer
+// http://www.tomsteer.net
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sacnmerge.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SACN_MERGE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SACN_MERGE_NEON
+#include <arm_neon.h>
+#endif
+
+void sACNMergeEffectivePriorities(const uint1* priorities, bool per_address,
+                                  uint1* effective_priorities, int count)
+{
+    int i = 0;
+    if(!per_address)
+    {
+        // One priority for all addresses, saturated so that 255 stays valid
+        const uint1 priority = priorities[0];
+        const uint1 effective = (priority == 255) ? 255 : uint1(priority + 1);
+        for(; i<count; i++)
+            effective_priorities[i] = effective;
+        return;
+    }
+
+#if defined(SACN_MERGE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    for(; i+16<=count; i+=16)
+    {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(priorities + i));
+        // priority + 1, but 0 stays 0 (excluded)
+        __m128i excluded = _mm_cmpeq_epi8(p, zero);
+        __m128i e = _mm_andnot_si128(excluded, _mm_adds_epu8(p, one));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(effective_priorities + i), e);
+    }
+#elif defined(SACN_MERGE_NEON)
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t one = vdupq_n_u8(1);
+    for(; i+16<=count; i+=16)
+    {
+        uint8x16_t p = vld1q_u8(priorities + i);
+        uint8x16_t excluded = vceqq_u8(p, zero);
+        uint8x16_t e = vbicq_u8(vqaddq_u8(p, one), excluded);
+        vst1q_u8(effective_priorities + i, e);
+    }
+#endif
+    for(; i<count; i++)
+    {
+        const uint1 p = priorities[i];
+        effective_priorities[i] = (p == 0) ? 0 : ((p == 255) ? 255 : uint1(p + 1));
+    }
+}
+
+void sACNMergeSource(const uint1* levels, const uint1* effective_priorities,
+                     uint1* merged_priorities, uint1* merged_levels, int count)
+{
+    int i = 0;
+#if defined(SACN_MERGE_SSE2)
+    for(; i+16<=count; i+=16)
+    {
+        __m128i level = _mm_loadu_si128(reinterpret_cast<const __m128i*>(levels + i));
+        __m128i prio = _mm_loadu_si128(reinterpret_cast<const __m128i*>(effective_priorities + i));
+        __m128i mergedPrio = _mm_loadu_si128(reinterpret_cast<const __m128i*>(merged_priorities + i));
+        __m128i mergedLevel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(merged_levels + i));
+
+        __m128i newPrio = _mm_max_epu8(mergedPrio, prio);
+        // higher priority: all bytes where the maximum changed
+        __m128i higher = _mm_xor_si128(_mm_cmpeq_epi8(newPrio, mergedPrio), _mm_set1_epi8(-1));
+        __m128i equal = _mm_cmpeq_epi8(prio, mergedPrio);
+
+        __m128i htp = _mm_max_epu8(mergedLevel, level);
+        __m128i result = _mm_or_si128(_mm_and_si128(equal, htp), _mm_andnot_si128(equal, mergedLevel));
+        result = _mm_or_si128(_mm_and_si128(higher, level), _mm_andnot_si128(higher, result));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(merged_priorities + i), newPrio);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(merged_levels + i), result);
+    }
+#elif defined(SACN_MERGE_NEON)
+    for(; i+16<=count; i+=16)
+    {
+        uint8x16_t level = vld1q_u8(levels + i);
+        uint8x16_t prio = vld1q_u8(effective_priorities + i);
+        uint8x16_t mergedPrio = vld1q_u8(merged_priorities + i);
+        uint8x16_t mergedLevel = vld1q_u8(merged_levels + i);
+
+        uint8x16_t higher = vcgtq_u8(prio, mergedPrio);
+        uint8x16_t equal = vceqq_u8(prio, mergedPrio);
+
+        uint8x16_t result = vbslq_u8(equal, vmaxq_u8(mergedLevel, level), mergedLevel);
+        result = vbslq_u8(higher, level, result);
+
+        vst1q_u8(merged_priorities + i, vmaxq_u8(mergedPrio, prio));
+        vst1q_u8(merged_levels + i, result);
+    }
+#endif
+    for(; i<count; i++)
+    {
+        const uint1 prio = effective_priorities[i];
+        if(prio > merged_priorities[i])
+        {
+            merged_priorities[i] = prio;
+            merged_levels[i] = levels[i];
+        }
+        else if(prio == merged_priorities[i] && levels[i] > merged_levels[i])
+        {
+            merged_levels[i] = levels[i];
+        }
+    }
+}
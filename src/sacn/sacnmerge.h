@@ -0,0 +1,48 @@
+// Copyright 2016 Tom Barthel-Steer
+// http://www.tomsteer.net
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SACNMERGE_H
+#define SACNMERGE_H
+
+#include "ACNShare/deftypes.h"
+
+/*
+ * Merge kernels for sACN, they work on whole level and priority arrays of a source
+ * instead of single addresses. The inner loops use SSE2 or NEON when available.
+ *
+ * The merge works with "effective priorities": 0 means the source doesn't take part for
+ * this address, otherwise it is the sACN priority + 1 (so that priority 0 of a source
+ * without per-address priority still wins over no source at all).
+ */
+
+/*
+ * Fills effective_priorities for a source:
+ * with per-address priority, addresses with priority 0 are excluded,
+ * otherwise all addresses use the given priority (the source priority).
+ */
+void sACNMergeEffectivePriorities(const uint1* priorities, bool per_address,
+                                  uint1* effective_priorities, int count);
+
+/*
+ * Merges one source into the running result:
+ * a higher effective priority replaces the merged level, an equal one uses the
+ * highest level (HTP). merged_priorities and merged_levels have to be zeroed
+ * before the first source.
+ * An address has a valid level after all sources are merged if merged_priorities is not 0.
+ */
+void sACNMergeSource(const uint1* levels, const uint1* effective_priorities,
+                     uint1* merged_priorities, uint1* merged_levels, int count);
+
+#endif // SACNMERGE_H
@@ -0,0 +1,274 @@
+// Copyright 2016 Tom Barthel-Steer
+// http://www.tomsteer.net
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sacnreceiver.h"
+
+#include "sacnlistener.h"
+#include "sacnsocket.h"
+#include "streamcommon.h"
+#include "ACNShare/defpack.h"
+#include "ACNShare/ipaddr.h"
+#include <QNetworkInterface>
+#include <QMutexLocker>
+#include <QThread>
+#include <QDebug>
+#include <cstring>
+
+#ifdef SACN_USE_RECVMMSG
+#include <cerrno>
+#endif
+
+// Valid universes are 1-63999
+#define MAX_UNIVERSE 63999
+
+// Largest sACN packet (universe discovery), all data packets are smaller
+#define MAX_PACKET_SIZE 1144
+
+// Number of datagrams read with one recvmmsg call
+#define RECEIVE_BATCH_SIZE 32
+
+sACNReceiver::sACNReceiver(QObject *parent) : QObject(parent),
+    m_socket(nullptr),
+    m_listenerTable(MAX_UNIVERSE + 1, nullptr),
+    m_receiveCallCount(0),
+    m_datagramCount(0)
+#ifdef SACN_USE_RECVMMSG
+    , m_recvmmsgFailed(false)
+#endif
+{
+}
+
+sACNReceiver::~sACNReceiver()
+{
+    // m_socket is deleted as child
+}
+
+void sACNReceiver::startReception()
+{
+    qDebug() << "sACNReceiver" << QThread::currentThreadId() << ": Starting reception";
+
+    // One socket for unicast and all joined multicast groups
+    m_socket = new sACNRxSocket(this);
+    if(!m_socket->bindUnicast())
+    {
+        qWarning() << "sACNReceiver: Failed to bind RX socket, no sACN will be received";
+        return;
+    }
+    m_localAddress = m_socket->localAddress();
+    connect(m_socket, SIGNAL(readyRead()), this, SLOT(readPendingDatagrams()), Qt::DirectConnection);
+
+#ifdef SACN_USE_RECVMMSG
+    m_receiveBuffer.resize(RECEIVE_BATCH_SIZE * MAX_PACKET_SIZE);
+    m_messages.resize(RECEIVE_BATCH_SIZE);
+    m_iovecs.resize(RECEIVE_BATCH_SIZE);
+    m_senders.resize(RECEIVE_BATCH_SIZE);
+#endif
+
+    // Join the groups of listeners that were added before the socket existed
+    QMutexLocker locker(&m_listenerMutex);
+    for(int universe=1; universe<=MAX_UNIVERSE; universe++)
+    {
+        if(m_listenerTable[universe])
+            joinUniverse(universe);
+    }
+}
+
+void sACNReceiver::addListener(int universe, sACNListener *listener)
+{
+    if(universe < 1 || universe > MAX_UNIVERSE)
+        return;
+    {
+        QMutexLocker locker(&m_listenerMutex);
+        m_listenerTable[universe] = listener;
+    }
+    // Sockets can only be used in their thread
+    QMetaObject::invokeMethod(this, "joinUniverse", Qt::QueuedConnection, Q_ARG(int, universe));
+}
+
+void sACNReceiver::removeListener(int universe, sACNListener *listener)
+{
+    if(universe < 1 || universe > MAX_UNIVERSE)
+        return;
+    {
+        QMutexLocker locker(&m_listenerMutex);
+        if(m_listenerTable[universe] != listener)
+            return;
+        m_listenerTable[universe] = nullptr;
+    }
+    QMetaObject::invokeMethod(this, "leaveUniverse", Qt::QueuedConnection, Q_ARG(int, universe));
+}
+
+void sACNReceiver::joinUniverse(int universe)
+{
+    if(!m_socket || m_socket->state() != QAbstractSocket::BoundState)
+        return;
+
+    CIPAddr addr;
+    GetUniverseAddress(universe, addr);
+    QHostAddress group(addr.GetV4Address());
+
+    // Join on each interface that can receive multicast
+    bool joined = false;
+    foreach(const QNetworkInterface &iface, QNetworkInterface::allInterfaces())
+    {
+        const QNetworkInterface::InterfaceFlags flags = iface.flags();
+        if(!(flags & QNetworkInterface::IsUp) || !(flags & QNetworkInterface::IsRunning)
+                || !(flags & QNetworkInterface::CanMulticast))
+            continue;
+        joined |= m_socket->joinMulticastGroup(group, iface);
+    }
+    // Fall back to the default interface
+    if(!joined)
+        joined = m_socket->joinMulticastGroup(group);
+
+    if(joined)
+        qDebug() << "sACNReceiver" << QThread::currentThreadId() << ": Joining Multicast Group:" << group.toString();
+    else
+        qDebug() << "sACNReceiver" << QThread::currentThreadId() << ": Failed to join Multicast Group:" << group.toString();
+}
+
+void sACNReceiver::leaveUniverse(int universe)
+{
+    if(!m_socket || m_socket->state() != QAbstractSocket::BoundState)
+        return;
+    {
+        // The universe may have been listened to again in the meantime
+        QMutexLocker locker(&m_listenerMutex);
+        if(m_listenerTable[universe])
+            return;
+    }
+
+    CIPAddr addr;
+    GetUniverseAddress(universe, addr);
+    QHostAddress group(addr.GetV4Address());
+
+    foreach(const QNetworkInterface &iface, QNetworkInterface::allInterfaces())
+    {
+        const QNetworkInterface::InterfaceFlags flags = iface.flags();
+        if(!(flags & QNetworkInterface::IsUp) || !(flags & QNetworkInterface::CanMulticast))
+            continue;
+        m_socket->leaveMulticastGroup(group, iface);
+    }
+    m_socket->leaveMulticastGroup(group);
+}
+
+void sACNReceiver::readPendingDatagrams()
+{
+    #if (QT_VERSION == QT_VERSION_CHECK(5, 9, 3))
+        #error "QT5.9.3 QUdpSocket::readDatagram Returns incorrect infomation: https://bugreports.qt.io/browse/QTBUG-64784"
+    #endif
+    #if (QT_VERSION == QT_VERSION_CHECK(5, 10, 0))
+        #error "QT5.10.0 QUdpSocket::readDatagram Returns incorrect infomation: https://bugreports.qt.io/browse/QTBUG-65099"
+    #endif
+
+#ifdef SACN_USE_RECVMMSG
+    if(!m_recvmmsgFailed && readWithRecvmmsg())
+        return;
+#endif
+
+    char buffer[MAX_PACKET_SIZE];
+    while(m_socket->hasPendingDatagrams())
+    {
+        QHostAddress sender;
+        qint64 size = m_socket->readDatagram(buffer, sizeof(buffer), &sender);
+        m_receiveCallCount++;
+        if(size <= 0)
+            continue;
+        dispatchDatagram(QByteArray::fromRawData(buffer, int(size)), sender);
+    }
+}
+
+#ifdef SACN_USE_RECVMMSG
+bool sACNReceiver::readWithRecvmmsg()
+{
+    const int socketDescriptor = int(m_socket->socketDescriptor());
+
+    for(;;)
+    {
+        for(int i=0; i<RECEIVE_BATCH_SIZE; i++)
+        {
+            m_iovecs[i].iov_base = m_receiveBuffer.data() + i * MAX_PACKET_SIZE;
+            m_iovecs[i].iov_len = MAX_PACKET_SIZE;
+            std::memset(&m_messages[i], 0, sizeof(mmsghdr));
+            m_messages[i].msg_hdr.msg_name = &m_senders[i];
+            m_messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            m_messages[i].msg_hdr.msg_iov = &m_iovecs[i];
+            m_messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int received = ::recvmmsg(socketDescriptor, m_messages.data(), RECEIVE_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        m_receiveCallCount++;
+        if(received < 0)
+        {
+            if(errno == ENOSYS)
+            {
+                qWarning() << "sACNReceiver: recvmmsg not available, reading datagrams separately";
+                m_recvmmsgFailed = true;
+                return false;
+            }
+            // EAGAIN: everything was read
+            break;
+        }
+
+        for(int i=0; i<received; i++)
+        {
+            const char *data = static_cast<const char *>(m_iovecs[i].iov_base);
+            QHostAddress sender(ntohl(m_senders[i].sin_addr.s_addr));
+            dispatchDatagram(QByteArray::fromRawData(data, int(m_messages[i].msg_len)), sender);
+        }
+
+        if(received < RECEIVE_BATCH_SIZE)
+            break;
+    }
+
+    // QUdpSocket disables its read notification after readyRead() until readDatagram() is called,
+    // this also picks up a datagram that arrived in the meantime
+    char buffer[MAX_PACKET_SIZE];
+    QHostAddress sender;
+    qint64 size = m_socket->readDatagram(buffer, sizeof(buffer), &sender);
+    m_receiveCallCount++;
+    if(size > 0)
+        dispatchDatagram(QByteArray::fromRawData(buffer, int(size)), sender);
+    return true;
+}
+#endif
+
+void sACNReceiver::dispatchDatagram(const QByteArray &data, const QHostAddress &sender)
+{
+    m_datagramCount++;
+
+    // Find the universe without validating the whole packet, the listener does that
+    if(data.size() < DRAFT_UNIVERSE_ADDR + 2)
+        return;
+    const uint1 *pbuf = reinterpret_cast<const uint1 *>(data.constData());
+    const uint4 rootVector = UpackB4(pbuf + ROOT_VECTOR_ADDR);
+    int universe = 0;
+    if(rootVector == ROOT_VECTOR && data.size() >= UNIVERSE_ADDR + 2)
+        universe = UpackB2(pbuf + UNIVERSE_ADDR);
+    else if(rootVector == DRAFT_ROOT_VECTOR)
+        universe = UpackB2(pbuf + DRAFT_UNIVERSE_ADDR);
+    if(universe < 1 || universe > MAX_UNIVERSE)
+        return;
+
+    // Listeners live in this thread and are only deleted here, so the listener
+    // can be called after the lock was released
+    sACNListener *listener;
+    {
+        QMutexLocker locker(&m_listenerMutex);
+        listener = m_listenerTable[universe];
+    }
+    if(listener)
+        listener->processDatagram(data, m_localAddress, sender);
+}
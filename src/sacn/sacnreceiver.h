@@ -0,0 +1,99 @@
+// Copyright 2016 Tom Barthel-Steer
+// http://www.tomsteer.net
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SACNRECEIVER_H
+#define SACNRECEIVER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QHostAddress>
+#include <QByteArray>
+#include <vector>
+
+#include "ACNShare/deftypes.h"
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#define SACN_USE_RECVMMSG
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+// Forward Declarations
+class sACNListener;
+class sACNRxSocket;
+
+/**
+ * @brief The sACNReceiver class receives sACN for all listened universes.
+ *
+ * It lives in a single thread together with all sACNListeners. One socket receives
+ * unicast and multicast packets, the multicast groups of a universe are joined on all
+ * multicast capable interfaces while a listener for it exists. Packets are passed to the
+ * listener of their universe using a flat lookup table. On Linux the datagrams
+ * are read in batches with recvmmsg.
+ * Use sACNManager to get listeners, it registers them here.
+ */
+class sACNReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit sACNReceiver(QObject *parent = nullptr);
+    virtual ~sACNReceiver();
+
+    /**
+     * @brief addListener registers the listener of a universe and joins its multicast group,
+     * can be called from any thread
+     */
+    void addListener(int universe, sACNListener *listener);
+    /**
+     * @brief removeListener unregisters the listener of a universe and leaves its multicast group,
+     * can be called from any thread, no datagrams are passed to the listener after it returned.
+     * Nothing is changed if another listener is registered for the universe in the meantime.
+     */
+    void removeListener(int universe, sACNListener *listener);
+
+    // Diagnostic - the number of receive syscalls and datagrams since the start
+    quint64 receiveCallCount() const { return m_receiveCallCount; }
+    quint64 datagramCount() const { return m_datagramCount; }
+
+public slots:
+    void startReception();
+private slots:
+    void readPendingDatagrams();
+    void joinUniverse(int universe);
+    void leaveUniverse(int universe);
+private:
+    void dispatchDatagram(const QByteArray &data, const QHostAddress &sender);
+#ifdef SACN_USE_RECVMMSG
+    bool readWithRecvmmsg();
+#endif
+
+    sACNRxSocket *m_socket;
+    // Listener of each universe (index 0 and above 63999 are invalid), guarded by m_listenerMutex
+    std::vector<sACNListener *> m_listenerTable;
+    QMutex m_listenerMutex;
+    QHostAddress m_localAddress;
+    quint64 m_receiveCallCount;
+    quint64 m_datagramCount;
+
+#ifdef SACN_USE_RECVMMSG
+    std::vector<char> m_receiveBuffer;
+    std::vector<mmsghdr> m_messages;
+    std::vector<iovec> m_iovecs;
+    std::vector<sockaddr_in> m_senders;
+    bool m_recvmmsgFailed;  // true if recvmmsg is not available, uses readDatagram afterwards
+#endif
+};
+
+#endif // SACNRECEIVER_H
@@ -242,7 +242,7 @@ void CStreamServer::shutdown()
     m_instance = Q_NULLPTR;
 }
 
-CStreamServer::CStreamServer()
+CStreamServer::CStreamServer() : m_tickQueued(false)
 {
     m_sendsock = new sACNTxSocket();
 
@@ -250,10 +250,11 @@ CStreamServer::CStreamServer()
 
     m_thread = new QThread();
     connect(m_thread, &QThread::finished, this, &QObject::deleteLater);
+    // Started by UpdateTickTimer() for the next deadline
     m_tickTimer = new QTimer(this);
-    m_tickTimer->setInterval(10);
+    m_tickTimer->setSingleShot(true);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
     connect(m_tickTimer, SIGNAL(timeout()), this, SLOT(Tick()), Qt::DirectConnection);
-    m_tickTimer->start();
     this->moveToThread(m_thread);
     m_thread->start();
 }
@@ -316,55 +317,123 @@ void CStreamServer::RemovePSeq(const CID &cid, uint2 universe)
 
 void CStreamServer::Tick()
 {
+    m_tickQueued = false;
     QMutexLocker locker(&m_writeMutex);
 
-    int valid_count = 0;
-    for(verseiter it = m_multiverse.begin(); it != m_multiverse.end(); ++it)
+    // Only the universes that are due are looked at
+    tock now = Tock_GetTock();
+    while(!m_schedule.empty() && m_schedule.top().due <= now)
     {
-        if(it->psend)
-            ++valid_count;
+        const deadline next = m_schedule.top();
+        m_schedule.pop();
+
+        universe *it = &m_multiverse[next.handle];
+        if(!it->scheduled || it->schedule_id != next.schedule_id)
+            continue; // Rescheduled or destroyed in the meantime
+        it->scheduled = false;
+
+        //Not sent until marked dirty the first time
+        if(!it->psend || !it->waited_for_dirty)
+            continue;
+
+        //Before the send, properly reset state
+        if(it->isdirty)
+            it->inactive_count = 0;  //To recover from inactivity
+        else if(it->inactive_count < 3)  //We don't want the Expired case to reset the inactivity count
+            ++it->inactive_count;
+
+        //Add the sequence number and send
+        uint1 *pseq = GetPSeq(it->cid, it->number);
+        SetStreamHeaderSequence(it->psend, *pseq, it->draft);
+        (*pseq)++;
+
+        quint64 result = m_sendsock->writeDatagram( (char*)it->psend, it->sendsize, it->sendaddr, STREAM_IP_PORT);
+        if(result!=it->sendsize)
+        {
+            qDebug() << "Error sending datagram : " << m_sendsock->errorString();
+        }
+
+        if(GetStreamTerminated(it->psend))
+        {
+            it->num_terminates++;
+        }
 
         //If this has been send 3 times (or more?) with a termination flag
         //then it's time to kill it
         if(it->num_terminates >= 3)
         {
             DoDestruction(it->handle);
+            continue;
         }
 
-        //If valid, either a dirty, inactivity count < 3 (if we're using that logic), or send_interval will cause a send
-        if(it->psend && (it->isdirty ||
-                             (it->waited_for_dirty &&
-                                ((!it->ignore_inactivity && it->inactive_count < 3) ||
-                                 it->send_interval.Expired()))))
-        {
-            //Before the send, properly reset state
-            if(it->isdirty)
-                it->inactive_count = 0;  //To recover from inactivity
-            else if(it->inactive_count < 3)  //We don't want the Expired case to reset the inactivity count
-                ++it->inactive_count;
-
-            //Add the sequence number and send
-            uint1 *pseq = GetPSeq(it->cid, it->number);
-            SetStreamHeaderSequence(it->psend, *pseq, it->draft);
-            (*pseq)++;
-
-            quint64 result = m_sendsock->writeDatagram( (char*)it->psend, it->sendsize, it->sendaddr, STREAM_IP_PORT);
-            if(result!=it->sendsize)
-            {
-                qDebug() << "Error sending datagram : " << m_sendsock->errorString();
-            }
-
-            if(GetStreamTerminated(it->psend))
-            {
-                it->num_terminates++;
-            }
-
-            //Finally, set the timing/dirtiness for the next interval
-            it->isdirty = false;
-            it->send_interval.Reset();
-        }
+        //Finally, set the timing/dirtiness for the next interval
+        it->isdirty = false;
+        it->send_interval.Reset();
+        ScheduleNextSend(it->handle, now);
     }
 
+    UpdateTickTimer();
+}
+
+void CStreamServer::ScheduleUniverse(uint handle, const tock &due)
+{
+    universe &uni = m_multiverse[handle];
+    if(uni.scheduled && uni.next_send <= due)
+        return;
+
+    uni.next_send = due;
+    uni.scheduled = true;
+    uni.schedule_id++;
+
+    deadline entry;
+    entry.due = due;
+    entry.handle = handle;
+    entry.schedule_id = uni.schedule_id;
+    m_schedule.push(entry);
+}
+
+void CStreamServer::ScheduleNextSend(uint handle, tock now)
+{
+    const universe &uni = m_multiverse[handle];
+
+    //Repeat a change (or the termination) 3 times quickly, otherwise keep alive with the send interval
+    uint4 interval;
+    if(GetStreamTerminated(uni.psend) || (!uni.ignore_inactivity && uni.inactive_count < 3))
+        interval = SEND_INTERVAL_INACTIVE;
+    else
+        interval = uint4(m_multiverse[handle].send_interval.GetInterval());
+
+    ScheduleUniverse(handle, tock(now.Getms() + interval));
+}
+
+void CStreamServer::UpdateTickTimer()
+{
+    //Drop the outdated entries, so the timer isn't started for them
+    while(!m_schedule.empty())
+    {
+        const deadline &next = m_schedule.top();
+        const universe &uni = m_multiverse[next.handle];
+        if(uni.scheduled && uni.schedule_id == next.schedule_id)
+            break;
+        m_schedule.pop();
+    }
+
+    if(m_schedule.empty())
+    {
+        m_tickTimer->stop();
+        return;
+    }
+
+    tock now = Tock_GetTock();
+    const tock due = m_schedule.top().due;
+    m_tickTimer->start((due > now) ? int(due - now) : 0);
+}
+
+void CStreamServer::WakeUp()
+{
+    //One queued Tick is enough for all universes marked dirty until it runs
+    if(!m_tickQueued.exchange(true))
+        QMetaObject::invokeMethod(this, "Tick", Qt::QueuedConnection);
 }
 
 
@@ -431,6 +500,7 @@ bool CStreamServer::CreateUniverse(const CID& source_cid, const char* source_nam
     m_multiverse[handle].send_interval.SetInterval(send_intervalms);
     m_multiverse[handle].draft = draft;
     m_multiverse[handle].cid = source_cid;
+    m_multiverse[handle].scheduled = false; //Not sent until marked dirty
 
     CIPAddr addr;
     GetUniverseAddress(universe, addr);
@@ -456,14 +526,16 @@ bool CStreamServer::CreateUniverse(const CID& source_cid, const char* source_nam
     return true;
 }
 
-//After you add data to the data buffer, call this to trigger the data send on
-//the next Tick boundary.
+//After you add data to the data buffer, call this to trigger the data send.
+//The send thread is woken up and sends it right away.
 //Otherwise, the data won't be sent until the inactivity or send_interval time.
 void CStreamServer::SetUniverseDirty(uint handle)
 {
     QMutexLocker locker(&m_writeMutex);
     m_multiverse[handle].isdirty = true;
     m_multiverse[handle].waited_for_dirty = true;
+    ScheduleUniverse(handle, Tock_GetTock());
+    WakeUp();
 }
 
 //In the event that you want to send out a message for a particular
@@ -496,8 +568,13 @@ void CStreamServer::DEBUG_DESTROY_PRIORITY_UNIVERSE(uint handle)
 void CStreamServer::DestroyUniverse(uint handle)
 {
     QMutexLocker locker(&m_writeMutex);
-    if(handle < m_multiverse.size())
+    if(handle < m_multiverse.size() && m_multiverse[handle].psend)
+    {
+        //Send the terminated packets right away
         SetStreamTerminated(m_multiverse[handle].psend, true);
+        ScheduleUniverse(handle, Tock_GetTock());
+        WakeUp();
+    }
 }
 
 //Perform the logical destruction and cleanup of a universe and its related
@@ -507,6 +584,7 @@ void CStreamServer::DoDestruction(uint handle)
   if(m_multiverse[handle].psend)
     {
       m_multiverse[handle].num_terminates = 0;
+      m_multiverse[handle].scheduled = false;
       delete [] m_multiverse[handle].psend;
       m_multiverse[handle].psend = NULL;
     }
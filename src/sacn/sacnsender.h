@@ -20,6 +20,8 @@
 #include <QMutex>
 #include <vector>
 #include <map>
+#include <queue>
+#include <atomic>
 #include <QSharedPointer>
 #include <QWeakPointer>
 #include "streamingacn.h"
@@ -173,6 +175,9 @@ private:
 #define SEND_INTERVAL_DMX	850	/*If no data has been sent in 850ms, send another DMX packet*/
 #define SEND_INTERVAL_PRIORITY 1000	/*By default, per-channel priority packets are sent once per second*/
 
+//After a change, the packet is repeated 3 times in this interval before the send_intervalms is used
+#define SEND_INTERVAL_INACTIVE 10
+
 //Bitflags for the options parameter of Create Universe.
 //Alternatively, you can directly set them while a universe is running with
 //OptionsPreviewData and OptionsStreamTerminated.  The terminated option doesn't
@@ -213,8 +218,8 @@ public:
                               bool ignore_inactivity_logic = IGNORE_INACTIVE_DMX,
                               uint send_intervalms = SEND_INTERVAL_DMX, CIPAddr unicastAddress = CIPAddr(), bool draft = false);
 
-  //After you add data to the data buffer, call this to trigger the data send
-  //on the next Tick boundary.
+  //After you add data to the data buffer, call this to trigger the data send.
+  //The send thread is woken up and sends it right away.
   //Otherwise, the data won't be sent until the inactivity or send_interval
   //time.
   //Due to the fact that access to the universes needs to be thread safe,
@@ -256,7 +261,7 @@ public:
    virtual void OptionsStreamTerminated(uint handle, bool terminated);
 private slots:
   /**
-   * @brief Tick - called every 10ms, handles transmission of sACN
+   * @brief Tick - called when the next universe is due, handles transmission of sACN
    */
   void Tick();
 
@@ -303,10 +308,14 @@ private:
         QHostAddress sendaddr;      //The multicast address we're sending to
         bool draft;                 //Draft or released sACN
         CID cid;                    // The CID
+        tock next_send;             //When the universe has to be sent next (if scheduled)
+        bool scheduled;             //If there is a valid entry in m_schedule
+        uint schedule_id;           //Identifies the valid entry in m_schedule, older ones are ignored
 
         //and the constructor
       universe():number(0),handle(0), num_terminates(0), psend(nullptr),isdirty(false),
-          waited_for_dirty(false),inactive_count(0),draft(false), cid() {}
+          waited_for_dirty(false),inactive_count(0),draft(false), cid(),
+          scheduled(false), schedule_id(0) {}
     };
 
     //The handle is the vector index
@@ -318,6 +327,32 @@ private:
    //and its related objects.
    void DoDestruction(uint handle);
 
+   //The send deadlines of all universes, the earliest one on top.
+   //Entries are not removed when a universe is rescheduled, instead they
+   //are ignored when their schedule_id doesn't match anymore.
+   struct deadline
+   {
+       tock due;
+       uint handle;
+       uint schedule_id;
+   };
+   struct laterDeadline
+   {
+       bool operator()(const deadline &a, const deadline &b) const { return a.due > b.due; }
+   };
+   std::priority_queue<deadline, std::vector<deadline>, laterDeadline> m_schedule;
+
+   //Schedules a send of the universe, an earlier deadline is kept
+   void ScheduleUniverse(uint handle, const tock &due);
+   //Schedules the next send after the universe has been sent
+   void ScheduleNextSend(uint handle, tock now);
+   //Starts the tick timer for the earliest deadline, call only in the send thread
+   void UpdateTickTimer();
+   //Wakes up the send thread to send dirty universes right away
+   void WakeUp();
+   //True while a Tick is queued by WakeUp()
+   std::atomic<bool> m_tickQueued;
+
    // Mutex for write protection of members
    QMutex m_writeMutex;
 };
@@ -0,0 +1,46 @@
+// Copyright 2016 Tom Barthel-Steer
+// http://www.tomsteer.net
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sacnsubscription.h"
+
+#include "sacnlistener.h"
+
+sACNRangeSubscription::sACNRangeSubscription(QSharedPointer<sACNListener> listener, int start, int count, QObject *parent) :
+    QObject(parent),
+    m_listener(listener),
+    m_universe(listener->universe()),
+    m_start(qBound(0, start, 511)),
+    m_count(qBound(0, count, 512 - m_start))
+{
+    // Register first, so that no merge is missed between reading and registering
+    m_listener->addSubscription(this);
+    // Current levels, later ones are delivered by the listener
+    m_levels.resize(m_count);
+    m_listener->readLevels(m_start, m_count, reinterpret_cast<uint8_t *>(m_levels.data()));
+}
+
+sACNRangeSubscription::~sACNRangeSubscription()
+{
+    // Nothing is delivered after this returned
+    m_listener->removeSubscription(this);
+}
+
+void sACNRangeSubscription::deliverLevels(const QByteArray &levels)
+{
+    if(levels == m_levels)
+        return;
+    m_levels = levels;
+    emit levelsChanged();
+}
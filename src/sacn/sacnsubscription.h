@@ -0,0 +1,74 @@
+// Copyright 2016 Tom Barthel-Steer
+// http://www.tomsteer.net
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SACNSUBSCRIPTION_H
+#define SACNSUBSCRIPTION_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QByteArray>
+
+// Forward Declarations
+class sACNListener;
+
+/**
+ * @brief The sACNRangeSubscription class delivers the merged levels of a range of addresses
+ * of a universe.
+ *
+ * levelsChanged() is emitted in the thread of the subscription only if a level in its range
+ * changed in a merge, the new levels are delivered with it. This is cheaper than connecting to
+ * sACNListener::levelsChanged() when only a few addresses are used.
+ * Create it with sACNManager::subscribe(), it keeps the listener of the universe alive.
+ */
+class sACNRangeSubscription : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief sACNRangeSubscription subscribes to a range of a listener
+     * @param listener listener of the universe
+     * @param start 0-based index of the first address
+     * @param count number of addresses, limited to the end of the universe
+     */
+    sACNRangeSubscription(QSharedPointer<sACNListener> listener, int start, int count, QObject *parent = nullptr);
+    virtual ~sACNRangeSubscription();
+
+    int universe() const { return m_universe; }
+    int start() const { return m_start; }
+    int count() const { return m_count; }
+
+    /**
+     * @brief levels
+     * @return the last delivered levels of the range, 0 if no source is sending an address
+     */
+    const QByteArray &levels() const { return m_levels; }
+    int level(int index) const { return (index >= 0 && index < m_levels.size()) ? quint8(m_levels[index]) : 0; }
+
+signals:
+    void levelsChanged();
+
+private slots:
+    // called by the listener (queued) with the levels of the range
+    void deliverLevels(const QByteArray &levels);
+
+private:
+    QSharedPointer<sACNListener> m_listener;
+    int m_universe;
+    int m_start;
+    int m_count;
+    QByteArray m_levels;
+};
+
+#endif // SACNSUBSCRIPTION_H
@@ -38,6 +38,8 @@
 #include "streamingacn.h"
 
 #include "sacnlistener.h"
+#include "sacnreceiver.h"
+#include "sacnsubscription.h"
 
 #include <QCoreApplication>
 #include <QThread>
@@ -82,13 +84,22 @@ sACNManager *sACNManager::getInstance()
 
 sACNManager::sACNManager() : QObject()
 {
-
+    // One thread receives all universes, instead of one thread per universe
+    m_receiverThread = new QThread;
+    m_receiverThread->setObjectName("sACN RX");
+    m_receiver = new sACNReceiver();
+    m_receiver->moveToThread(m_receiverThread);
+    connect(m_receiverThread, SIGNAL(started()), m_receiver, SLOT(startReception()));
+    connect(m_receiverThread, SIGNAL(finished()), m_receiver, SLOT(deleteLater()));
+    m_receiverThread->start(QThread::HighPriority);
 }
 
 static void strongPointerDelete(sACNListener *obj)
 {
-    obj->deleteLater();
+    // Unregister first, so that no datagram is passed to the listener after it was deleted
+    obj->markDeleted();
     sACNManager::getInstance()->listenerDelete(obj);
+    obj->deleteLater();
 }
 
 QSharedPointer<sACNListener> sACNManager::getListener(int universe)
@@ -105,18 +116,11 @@ QSharedPointer<sACNListener> sACNManager::getListener(int universe)
     {
         qDebug() << "Creating Listener for universe " << universe;
 
-        // Create thread and move listener to thread
-        QThread *thread = new QThread;
-        thread->setObjectName(QString("Universe %1 RX").arg(universe));
-
+        // Move listener to the shared receive thread
         sACNListener *listener = new sACNListener(universe);
-        listener->moveToThread(thread);
-        connect(thread, SIGNAL(started()), listener, SLOT(startReception()));
-        connect(thread, SIGNAL(finished()), listener, SLOT(deleteLater()));
-        connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-        thread->start(QThread::HighPriority);
-
-        m_listenerThreads[universe] = thread;
+        listener->moveToThread(m_receiverThread);
+        // The listener registers itself at the receiver when it started
+        QMetaObject::invokeMethod(listener, "startReception", Qt::QueuedConnection);
 
         // Create strong pointer to return
         strongPointer = QSharedPointer<sACNListener>(listener, strongPointerDelete);
@@ -137,6 +141,11 @@ QSharedPointer<sACNListener> sACNManager::getListener(int universe)
     return strongPointer;
 }
 
+sACNRangeSubscription *sACNManager::subscribe(int universe, int start, int count, QObject *parent)
+{
+    return new sACNRangeSubscription(getListener(universe), start, count, parent);
+}
+
 void sACNManager::listenerDelete(QObject *obj)
 {
     QMutexLocker locker(&sACNManager_mutex);
@@ -148,7 +157,5 @@ void sACNManager::listenerDelete(QObject *obj)
 
     m_objToUniverse.remove(obj);
 
-    m_listenerThreads[universe]->exit();
-    m_listenerThreads[universe]->wait();
-    m_listenerThreads.remove(universe);
+    m_receiver->removeListener(universe, static_cast<sACNListener *>(obj));
 }
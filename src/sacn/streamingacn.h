@@ -36,6 +36,9 @@
 
 // Forward Declarations
 class sACNListener;
+class sACNReceiver;
+class sACNRangeSubscription;
+class QThread;
 class sACNSentUniverse;
 
 enum StreamingACNProtocolVersion
@@ -98,14 +101,23 @@ public:
 
     QSharedPointer<sACNListener> getListener(int universe);
 
+    // Subscribes to the addresses start to start+count-1 (0-based) of a universe,
+    // the caller owns the subscription
+    sACNRangeSubscription *subscribe(int universe, int start, int count, QObject *parent = Q_NULLPTR);
+
     const QHash<int, QWeakPointer<sACNListener> > getListenerList() { return m_listenerHash; }
+
+    // The receiver shared by all listeners
+    sACNReceiver *getReceiver() { return m_receiver; }
 public slots:
     void listenerDelete(QObject *obj = Q_NULLPTR);
 private:
     sACNManager();
     QMutex sACNManager_mutex;
     QHash<int, QWeakPointer<sACNListener> > m_listenerHash;
-    QHash<int, QThread *> m_listenerThreads;
+    // All listeners and the receiver live in this thread
+    QThread *m_receiverThread;
+    sACNReceiver *m_receiver;
     QHash<QObject*, int> m_objToUniverse;
     static sACNManager *m_instance;
 };